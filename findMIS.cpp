@@ -13,14 +13,34 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
+#include <list>
+#include <deque>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
+#include <linux/io_uring.h>
+#include <immintrin.h>
 #include <ios>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "levenshtein.h"
+#include "misfile.h"
 
 using namespace std;
 
+// The distance recorded in the binary MIS files written by this program
+const char METRIC = 'E';
+
 /*
  * Prints a k-mer given its binary encoding according to the following 
  * binary-to-base translation: 00 -> A, 01 -> C, 10 -> G, 11 -> T
@@ -42,15 +62,421 @@ void printKmer( unsigned long int enc, int k )
 }
 
 /*
- * Calculates the edit distance between 2 k-mers
+ * Writes a stream of bytes to a file in the background, so that the scans do
+ * not wait for the disk. Data is collected in page-aligned buffers; a full
+ * buffer is submitted through io_uring, or handed to a writer thread calling 
+ * pwrite where io_uring is not available, while the next one is filled. The
+ * file is opened with O_DIRECT where the file system supports it.
+ */
+class AsyncWriter
+{
+private:
+    static const unsigned int NUM_BUFFERS = 4;     // Buffers in rotation
+    static const unsigned long int BUFFER_SIZE = 1ul << 20; // Bytes each
+    static const unsigned long int ALIGNMENT = 4096; // For O_DIRECT
+
+    int fd;                           // The output file
+    bool direct;                      // True if opened with O_DIRECT
+    bool failed;                      // True if a write failed
+    char *buffers[NUM_BUFFERS];       // The aligned buffers
+    bool busy[NUM_BUFFERS];           // True while a buffer is being written
+    unsigned int cur;                 // The buffer being filled
+    unsigned long int used;           // Bytes used in the current buffer
+    unsigned long int offset;         // File offset of the current buffer
+
+    int ring;                         // The io_uring, -1 if not used
+    void *sqPtr, *cqPtr;              // The mapped rings
+    unsigned long int sqSize, cqSize; // The sizes of the mapped rings
+    unsigned int *sqTail, *sqMask, *sqArray; // The submission ring
+    unsigned int *cqHead, *cqTail, *cqMask;  // The completion ring
+    struct io_uring_sqe *sqes;        // The submission entries
+    struct io_uring_cqe *cqes;        // The completion entries
+    unsigned int numEntries;          // The number of submission entries
+
+    thread writer;                    // The writer thread of the fallback
+    mutex lock;                       // Guards busy and jobs
+    condition_variable changed;       // Signals new jobs and completions
+    deque<pair<unsigned int, unsigned long int>> jobs; // Buffer, length
+    deque<unsigned long int> jobOffsets;             // File offset per job
+    bool closing;                     // Tells the writer thread to finish
+
+    /*
+     * Returns true if the io_uring supports IORING_OP_WRITE. Kernels before
+     * 5.6 have neither the probe nor the opcode.
+     */
+    bool probeWrite()
+    {
+        unsigned long int len = sizeof(struct io_uring_probe) + 
+                                IORING_OP_LAST * 
+                                sizeof(struct io_uring_probe_op);
+        struct io_uring_probe *probe = (struct io_uring_probe *) 
+                                       calloc( 1, len );
+        bool supported = 
+            syscall( __NR_io_uring_register, ring, IORING_REGISTER_PROBE, 
+                     probe, IORING_OP_LAST ) >= 0 &&
+            probe->last_op >= IORING_OP_WRITE &&
+            (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+        free( probe );
+        return supported;
+    }
+
+    /*
+     * Sets up an io_uring with one entry per buffer. Returns false if the 
+     * kernel does not support it or its writes.
+     */
+    bool setupRing()
+    {
+        struct io_uring_params params;
+        memset( &params, 0, sizeof(params) );
+        ring = syscall( __NR_io_uring_setup, NUM_BUFFERS, &params );
+        if ( ring < 0 )
+        {
+            return false;
+        }
+        if ( !probeWrite() )
+        {
+            close( ring );
+            ring = -1;
+            return false;
+        }
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + 
+                 params.cq_entries * sizeof(struct io_uring_cqe);
+        if ( params.features & IORING_FEAT_SINGLE_MMAP )
+        {
+            sqSize = cqSize = max( sqSize, cqSize );
+        }
+        sqPtr = mmap( nullptr, sqSize, PROT_READ | PROT_WRITE, 
+                      MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING );
+        cqPtr = sqPtr;
+        if ( sqPtr != MAP_FAILED && 
+             !(params.features & IORING_FEAT_SINGLE_MMAP) )
+        {
+            cqPtr = mmap( nullptr, cqSize, PROT_READ | PROT_WRITE, 
+                          MAP_SHARED | MAP_POPULATE, ring, 
+                          IORING_OFF_CQ_RING );
+        }
+        numEntries = params.sq_entries;
+        sqes = (struct io_uring_sqe *) mmap( nullptr, 
+                   numEntries * sizeof(struct io_uring_sqe), 
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, 
+                   IORING_OFF_SQES );
+        if ( sqPtr == MAP_FAILED || cqPtr == MAP_FAILED || 
+             sqes == MAP_FAILED )
+        {
+            close( ring );
+            ring = -1;
+            return false;
+        }
+
+        char *sq = (char *) sqPtr;
+        char *cq = (char *) cqPtr;
+        sqTail = (unsigned int *) (sq + params.sq_off.tail);
+        sqMask = (unsigned int *) (sq + params.sq_off.ring_mask);
+        sqArray = (unsigned int *) (sq + params.sq_off.array);
+        cqHead = (unsigned int *) (cq + params.cq_off.head);
+        cqTail = (unsigned int *) (cq + params.cq_off.tail);
+        cqMask = (unsigned int *) (cq + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /*
+     * Collects the completed writes of the io_uring, waiting for at least one
+     * if asked to
+     *
+     * wait: True to wait for a completion
+     */
+    void reap( bool wait )
+    {
+        if ( wait )
+        {
+            syscall( __NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS,
+                     nullptr, 0 );
+        }
+        unsigned int head = *cqHead;
+        unsigned int tail = __atomic_load_n( cqTail, __ATOMIC_ACQUIRE );
+        for ( ; head != tail; ++head )
+        {
+            struct io_uring_cqe *cqe = &cqes[head & *cqMask];
+            unsigned int b = cqe->user_data & 0xffff;
+            if ( cqe->res != (int) (cqe->user_data >> 16) )
+            {
+                failed = true;
+            }
+            busy[b] = false;
+        }
+        __atomic_store_n( cqHead, head, __ATOMIC_RELEASE );
+    }
+
+    /*
+     * The loop of the writer thread of the fallback
+     */
+    void writerLoop()
+    {
+        unique_lock<mutex> guard(lock);
+        while ( true )
+        {
+            changed.wait( guard, [this] { return closing || !jobs.empty(); } );
+            if ( jobs.empty() )
+            {
+                return;
+            }
+            pair<unsigned int, unsigned long int> job = jobs.front();
+            unsigned long int off = jobOffsets.front();
+            guard.unlock();
+            ssize_t written = pwrite( fd, buffers[job.first], job.second, 
+                                      off );
+            guard.lock();
+            if ( written != (ssize_t) job.second )
+            {
+                failed = true;
+            }
+            jobs.pop_front();
+            jobOffsets.pop_front();
+            busy[job.first] = false;
+            changed.notify_all();
+        }
+    }
+
+    /*
+     * Starts writing a buffer to the file
+     *
+     * b  : The buffer
+     * len: The number of bytes to write
+     * off: The file offset
+     */
+    void submit( unsigned int b, unsigned long int len, unsigned long int off )
+    {
+        if ( ring < 0 )
+        {
+            lock_guard<mutex> guard(lock);
+            busy[b] = true;
+            jobs.push_back( make_pair(b, len) );
+            jobOffsets.push_back( off );
+            changed.notify_all();
+            return;
+        }
+        busy[b] = true;
+        unsigned int tail = *sqTail;
+        unsigned int index = tail & *sqMask;
+        struct io_uring_sqe *sqe = &sqes[index];
+        memset( sqe, 0, sizeof(*sqe) );
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = fd;
+        sqe->addr = (unsigned long int) buffers[b];
+        sqe->len = len;
+        sqe->off = off;
+        sqe->user_data = (len << 16) | b;
+        sqArray[index] = index;
+        __atomic_store_n( sqTail, tail + 1, __ATOMIC_RELEASE );
+        if ( syscall(__NR_io_uring_enter, ring, 1, 0, 0, nullptr, 0) != 1 )
+        {
+            failed = true;
+            busy[b] = false;
+        }
+    }
+
+    /*
+     * Waits until a buffer is free
+     *
+     * b: The buffer
+     */
+    void waitFree( unsigned int b )
+    {
+        if ( ring < 0 )
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait( guard, [this, b] { return !busy[b]; } );
+            return;
+        }
+        reap( false );
+        while ( busy[b] )
+        {
+            reap( true );
+        }
+    }
+
+public:
+    /*
+     * Constructor
+     *
+     * filename: The output file, created or truncated
+     */
+    AsyncWriter( const string &filename ) : failed(false), cur(0), used(0),
+                                            offset(0), ring(-1), 
+                                            closing(false)
+    {
+        direct = true;
+        fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT,
+                   0644 );
+        if ( fd < 0 )
+        {
+            direct = false;
+            fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        }
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            buffers[b] = (char *) aligned_alloc( ALIGNMENT, BUFFER_SIZE );
+            busy[b] = false;
+        }
+        if ( fd >= 0 && !setupRing() )
+        {
+            writer = thread( &AsyncWriter::writerLoop, this );
+        }
+    }
+
+    /*
+     * Destructor. Writes the rest of the data and waits for all writes.
+     */
+    ~AsyncWriter()
+    {
+        finish();
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            free( buffers[b] );
+        }
+    }
+
+    /*
+     * Writes the rest of the data, waits for all writes and closes the file.
+     * Returns true if all data was written.
+     */
+    bool finish()
+    {
+        if ( fd < 0 )
+        {
+            return !failed;
+        }
+
+        // O_DIRECT writes whole blocks, so the padding is cut off afterwards
+        unsigned long int len = used;
+        if ( direct )
+        {
+            len = (used + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            memset( buffers[cur] + used, 0, len - used );
+        }
+        if ( len > 0 )
+        {
+            submit( cur, len, offset );
+        }
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            waitFree( b );
+        }
+        if ( direct && ftruncate(fd, offset + used) != 0 )
+        {
+            failed = true;
+        }
+
+        if ( ring >= 0 )
+        {
+            munmap( sqes, numEntries * sizeof(struct io_uring_sqe) );
+            if ( cqPtr != sqPtr )
+            {
+                munmap( cqPtr, cqSize );
+            }
+            munmap( sqPtr, sqSize );
+            close( ring );
+        }
+        else
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                closing = true;
+                changed.notify_all();
+            }
+            writer.join();
+        }
+        close( fd );
+        fd = -1;
+        return !failed;
+    }
+
+    /*
+     * Returns true if the file could be opened
+     */
+    bool good() const
+    {
+        return fd >= 0;
+    }
+
+    /*
+     * Returns the name of the mechanism doing the writes
+     */
+    const char *backend() const
+    {
+        return ring >= 0 ? "io_uring" : "a writer thread";
+    }
+
+    /*
+     * Appends data to the file
+     *
+     * data: The data
+     * len : The number of bytes
+     */
+    void write( const char *data, unsigned long int len )
+    {
+        while ( len > 0 )
+        {
+            unsigned long int n = min( len, BUFFER_SIZE - used );
+            memcpy( buffers[cur] + used, data, n );
+            used += n;
+            data += n;
+            len -= n;
+            if ( used == BUFFER_SIZE )
+            {
+                submit( cur, BUFFER_SIZE, offset );
+                offset += BUFFER_SIZE;
+                cur = (cur + 1) % NUM_BUFFERS;
+                used = 0;
+                waitFree( cur );
+            }
+        }
+    }
+};
+
+// Where printMember writes the independent nodes, nullptr for the console
+AsyncWriter *memberOutput = nullptr;
+
+/*
+ * Prints a member of the independent set followed by a space, to the output
+ * file if one was given and to the console otherwise
+ *
+ * enc: The binary encoding of the k-mer
+ * k  : The length of the k-mer
+ */
+void printMember( unsigned long int enc, int k )
+{
+    if ( memberOutput == nullptr )
+    {
+        printKmer( enc, k );
+        cerr << ' ';
+        return;
+    }
+    char base[4] = {'A', 'C', 'G', 'T'};
+    char kmer[k + 1];
+    kmer[k] = ' ';
+    for (int i = k - 1; i >= 0; --i)
+    {
+        kmer[i] = base[enc & 3];
+        enc = enc >> 2;
+    }
+    memberOutput->write( kmer, k + 1 );
+}
+
+/*
+ * Calculates the edit distance between 2 k-mers with the full DP table. If the
+ * distance exceeds d, the returned value is only guaranteed to be larger 
+ * than d.
  *
  * s1: The encoding of the first k-mer
  * s2: The encoding of the second k-mer
  * k : The length of the two k-mers
  * d : The maximum edit distance allowed
  */
-int editDist( const unsigned long int s1, const unsigned long int s2, 
-              const int k, const int d )
+int editDistDP( const unsigned long int s1, const unsigned long int s2, 
+                const int k, const int d )
 {
     int DPtable[k + 1][k + 1];
     for (int i = 0; i < k + 1; ++i)
@@ -88,997 +514,5426 @@ int editDist( const unsigned long int s1, const unsigned long int s2,
 }
 
 /*
- * Reports the time and space usage
+ * Calculates the edit distance between 2 k-mers, only filling the cells of the
+ * DP table within the band |i - j| <= d. If the distance exceeds d, the 
+ * returned value is only guaranteed to be larger than d.
+ *
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ * k : The length of the two k-mers
+ * d : The maximum edit distance allowed
  */
-void reportPerformance()
+int editDistBanded( const unsigned long int s1, const unsigned long int s2, 
+                    const int k, const int d )
 {
-    string temp;
-    unsigned long int utime, stime, vmpeak, vmhwm;
-
-    // Find time usage in "/proc/self/stat"
-    ifstream time_stream("/proc/self/stat", ios_base::in);
-
-    // Skip all irrelevant attributes
-    for (int i = 0; i < 13; ++i)
-    {
-        time_stream >> temp;
-    }
-
-    time_stream >> utime >> stime;
-    time_stream.close();
-
-    // Find space usage in "/proc/self/status"
-    ifstream space_stream("/proc/self/status", ios_base::in);
-    while ( temp.compare("VmPeak:") != 0 )
+    // Cells outside the band are treated as d + 1
+    int prev[k + 2];
+    int cur[k + 2];
+    for (int j = 0; j < k + 2; ++j)
     {
-        space_stream >> temp;
+        prev[j] = (j <= d) ? j : d + 1;
+        cur[j] = d + 1;
     }
-    space_stream >> vmpeak;
-    while ( temp.compare("VmHWM:") != 0 )
+    for (int i = 1; i < k + 1; ++i)
     {
-        space_stream >> temp;
+        int lo = (i - d > 1) ? i - d : 1;
+        int hi = (i + d < k) ? i + d : k;
+        cur[lo - 1] = (lo == 1 && i <= d) ? i : d + 1;
+        for (int j = lo; j <= hi; ++j)
+        {
+            int v = prev[j - 1];
+            if ( ((s1 >> (2*(i-1))) & 3) != ((s2 >> (2*(j-1))) & 3) )
+            {
+                v++;
+            }
+            if ( prev[j] + 1 < v )
+            {
+                v = prev[j] + 1;
+            }
+            if ( cur[j - 1] + 1 < v )
+            {
+                v = cur[j - 1] + 1;
+            }
+            cur[j] = v;
+        }
+        cur[hi + 1] = d + 1;
+        if ( cur[i] > d )
+        {
+            return cur[i];
+        }
+        for (int j = lo - 1; j <= hi + 1; ++j)
+        {
+            prev[j] = cur[j];
+        }
     }
-    space_stream >> vmhwm;
-    space_stream.close();
+    return prev[k];
+}
 
-    cerr << "Performance Report\n"
-         << "Time in user mode:        " 
-         << utime / sysconf(_SC_CLK_TCK) << " sec\n"
-         << "Time in kernel mode:      " 
-         << stime / sysconf(_SC_CLK_TCK) << " sec\n"
-         << "Peak virtual memory size: " << vmpeak << " kB\n"
-         << "Peak resident set size:   " << vmhwm << " kB\n\n";
+/*
+ * Calculates the edit distance between 2 k-mers with Myers' bit-parallel
+ * algorithm (global variant by Hyyro), one column of the DP table per machine
+ * word operation. Requires k <= 63. If the distance exceeds d, the returned
+ * value is only guaranteed to be larger than d.
+ *
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ * k : The length of the two k-mers
+ * d : The maximum edit distance allowed
+ */
+int editDistBitParallel( const unsigned long int s1, 
+                         const unsigned long int s2, const int k, const int d )
+{
+    return LevenshteinAutomaton( s1, k, d ).dist( s2 );
 }
 
 /*
- * Implementation of the Simple Pairwise Comparison method with alphabetical
- * order of k-mer iteration
+ * Calculates the edit distance between 2 k-mers one anti-diagonal of the DP
+ * table at a time with AVX2 and BMI2, holding cell (i, t-i) of anti-diagonal 
+ * t in byte lane i. Values are capped at d + 1, so the bytes never overflow 
+ * and the cells outside the band |i - j| <= d stay at the cap; once two 
+ * consecutive anti-diagonals are at the cap the distance exceeds d. Falls 
+ * back to the bit-parallel kernel for k > 31. If the distance exceeds d, the 
+ * returned value is only guaranteed to be larger than d.
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ * k : The length of the two k-mers
+ * d : The maximum edit distance allowed
  */
-void doPairwiseCmp( const int k, const int d )
+__attribute__((target("avx2,bmi2")))
+int editDistAntiDiagonal( const unsigned long int s1, 
+                          const unsigned long int s2, const int k, const int d )
 {
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    vector<unsigned long int> MIS;
-    bool isCovered = false;
-    
-    cerr << "\nList of independent nodes: " << endl;
-    for ( unsigned long int i = 0; i < kmerSpaceSize; ++i )
+    if ( k > 31 )
     {
-        for ( const unsigned long int &j : MIS )
-        {
-            if ( editDist(i, j, k, d) <= d )
-            {
-                isCovered = true;
-                break;
-            }
-        }
+        return editDistBitParallel( s1, s2, k, d );
+    }
 
-        if ( isCovered )
+    // Lane i holds base i-1 of s1; base t-i-1 of s2 for lane i is read from
+    // s2 reversed at offset k-t, so each anti-diagonal is one unaligned load.
+    // The bases are spread to bytes 8 at a time, and the bytes past the end
+    // of s1 are set to 4 so that they never match
+    unsigned char bases1[40];
+    unsigned char bases2[96];
+    memset( bases1, 4, sizeof(bases1) );
+    memset( bases2, 5, sizeof(bases2) );
+    const unsigned long int spread = 0x0303030303030303ul;
+    for (int c = 0; 8 * c < k; ++c)
+    {
+        unsigned long int b1 = _pdep_u64( s1 >> (16 * c), spread );
+        unsigned long int b2 = _pdep_u64( s2 >> (16 * c), spread );
+        b2 = __builtin_bswap64( b2 );
+        memcpy( bases1 + 1 + 8 * c, &b1, 8 );
+        memcpy( bases2 + 24 + k - 8 * c, &b2, 8 );
+    }
+    __m256i lanes = _mm256_setr_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 
+                                      12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 
+                                      22, 23, 24, 25, 26, 27, 28, 29, 30, 31 );
+    __m256i outside = _mm256_or_si256( 
+                          _mm256_cmpgt_epi8(lanes, _mm256_set1_epi8(k)), 
+                          _mm256_cmpeq_epi8(lanes, _mm256_setzero_si256()) );
+    __m256i a = _mm256_blendv_epi8( 
+                    _mm256_loadu_si256((const __m256i *) bases1), 
+                    _mm256_set1_epi8(4), outside );
+
+    // Row -1 and column -1 are virtual cells at the cap, so the recurrence
+    // produces the first row and column by itself from cell (0, 0)
+    __m256i one = _mm256_set1_epi8( 1 );
+    __m256i cap = _mm256_set1_epi8( (char) (d + 1) );
+    __m256i first = _mm256_setr_epi8( (char) (d + 1), 0, 0, 0, 0, 0, 0, 0, 
+                                      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+                                      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 );
+    __m256i cur = _mm256_sub_epi8( cap, first );
+    __m256i prev_shifted = cap;
+    bool prev_capped = false;
+    for (int t = 1; t <= 2 * k; ++t)
+    {
+        // Move every cell of the previous anti-diagonal up one lane
+        __m256i cur_shifted = _mm256_alignr_epi8( cur, 
+                                  _mm256_permute2x128_si256(cur, cur, 0x08), 
+                                  15 );
+        cur_shifted = _mm256_max_epu8( cur_shifted, first );
+
+        __m256i b = _mm256_loadu_si256( (const __m256i *) 
+                                        (bases2 + 32 + k - t) );
+        __m256i mismatch = _mm256_andnot_si256( _mm256_cmpeq_epi8(a, b), 
+                                                one );
+        __m256i next = _mm256_add_epi8( 
+                           _mm256_min_epu8(cur_shifted, cur), one );
+        next = _mm256_min_epu8( next, 
+                                _mm256_add_epi8(prev_shifted, mismatch) );
+        next = _mm256_min_epu8( next, cap );
+
+        // A diagonal step skips an anti-diagonal, so every path to the last
+        // cell runs through one of two consecutive anti-diagonals
+        bool capped = _mm256_movemask_epi8(_mm256_cmpeq_epi8(next, cap)) == -1;
+        if ( capped && prev_capped )
         {
-            isCovered = false;
-            continue;
+            return d + 1;
         }
-
-        printKmer( i, k );
-        cerr << ' ';
-        MIS.push_back( i );
+        prev_capped = capped;
+        prev_shifted = cur_shifted;
+        cur = next;
     }
 
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
+    alignas(32) unsigned char result[32];
+    _mm256_store_si256( (__m256i *) result, cur );
+    return result[k];
 }
 
 /*
- * A class for the visited array used to mark if a k-mer has been visited
+ * The edit distance kernels that can be chosen by the autotuner
  */
-class VisitedArray
+typedef int (*EditDistKernel)( const unsigned long int, 
+                               const unsigned long int, const int, const int );
+const int NUM_KERNELS = 4;
+const char *kernelNames[NUM_KERNELS] = {"dp", "banded", "bitparallel", 
+                                        "antidiagonal"};
+EditDistKernel kernels[NUM_KERNELS] = {editDistDP, editDistBanded, 
+                                       editDistBitParallel, 
+                                       editDistAntiDiagonal};
+
+/*
+ * Returns whether the CPU can run a kernel
+ *
+ * kernel: The index of the kernel in kernels
+ */
+bool kernelSupported( int kernel )
 {
-private:
-    char *aptr;             // Array pointer
-    unsigned long int size; // The capacity of the whole array in elements
+    return kernels[kernel] != editDistAntiDiagonal || 
+           (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"));
+}
 
-public:
-    /*
-     * Constructor
+// The kernel used by editDist, selected by autotune()
+EditDistKernel editDistKernel = editDistDP;
+
+/*
+ * The strategies for scanning the MIS with one candidate: calling editDist 
+ * for every pair, compiling the candidate into a LevenshteinAutomaton, or 
+ * looking the candidate up in a DeletionIndex of the MIS
+ */
+const int SCAN_PAIRWISE = 0;
+const int SCAN_AUTOMATON = 1;
+const int SCAN_DELETION = 2;
+const int NUM_SCANS = 3;
+const char *scanNames[NUM_SCANS] = {"pairwise", "automaton", "deletion"};
+
+// The scan strategy of the greedy methods, selected by autotune()
+int scanStrategy = SCAN_PAIRWISE;
+
+/*
+ * Optional per-region cost counters of the scans. The k-mers are grouped by
+ * their first p bases into 4^p regions. A scan calls enter() with every 
+ * k-mer it handles; the time until the next call and the distance 
+ * calculations, askNeighbors hits and BFS nodes counted in between are 
+ * charged to the region of that k-mer. The counters are not atomic, so only
+ * single-threaded scans are instrumented.
+ */
+class RegionHeatmap
+{
+private:
+    int k;                                // The length of the k-mers
+    int p;                                // The bases of the region prefix
+    long int current;                     // The current region, -1 if none
+    chrono::steady_clock::time_point since; // When it was entered
+    vector<unsigned long int> kmers;      // K-mers handled per region
+    vector<double> seconds;               // Time per region
+    vector<unsigned long int> distCalls;  // Distance calculations
+    vector<unsigned long int> askHits;    // askNeighbors hits
+    vector<unsigned long int> bfsNodes;   // Nodes expanded by markBall
+
+    /*
+     * Writes one counter as a matrix with a row per first half of the 
+     * prefix and a column per second half
      *
-     * s: total number of elements
+     * out   : The output stream
+     * name  : The name of the counter
+     * values: The counter per region
      */
-    VisitedArray( unsigned long int s )
+    template <class T>
+    void writeMatrix( ostream &out, const char *name, 
+                      const vector<T> &values ) const
     {
-        aptr = (char *) calloc( s/8, 1 ); // Each element occupies 1 bit.
-        size = s;
+        const char bases[] = "ACGT";
+        int colBases = p / 2;
+        int rowBases = p - colBases;
+        unsigned long int cols = 1ul << (2 * colBases);
+        out << "# " << name << "\n" << "prefix";
+        for (unsigned long int c = 0; c < cols; ++c)
+        {
+            out << '\t';
+            for (int j = colBases - 1; j >= 0; --j)
+            {
+                out << bases[(c >> (2 * j)) & 3];
+            }
+        }
+        out << '\n';
+        for (unsigned long int r = 0; r < (1ul << (2 * rowBases)); ++r)
+        {
+            for (int j = rowBases - 1; j >= 0; --j)
+            {
+                out << bases[(r >> (2 * j)) & 3];
+            }
+            for (unsigned long int c = 0; c < cols; ++c)
+            {
+                out << '\t' << values[r * cols + c];
+            }
+            out << '\n';
+        }
+        out << '\n';
     }
 
+public:
     /*
-     * Destructor
+     * Constructor
+     *
+     * len   : The length of the k-mers
+     * prefix: The bases of the region prefix, clamped to 1 to min(k, 6)
      */
-    ~VisitedArray()
+    RegionHeatmap( int len, int prefix ) : k(len), current(-1)
     {
-        free( aptr );
+        p = max( 1, min(prefix, min(k, 6)) );
+        kmers.assign( 1ul << (2 * p), 0 );
+        seconds.assign( kmers.size(), 0 );
+        distCalls = askHits = bfsNodes = kmers;
     }
 
     /*
-     * Overload [] operator to return the value indexed by sub
+     * Charges the time since the last call to its region and starts 
+     * charging the region of a k-mer
      *
-     * sub: The index of the element to be extract
+     * kmer: The binary encoding of the k-mer handled next
      */
-    unsigned int operator[]( const unsigned long int &sub )
+    void enter( unsigned long int kmer )
     {
-        // Find the bit offset
-        int offset = sub % 8;
-
-        // Find the byte in which the required element is located
-        unsigned long int bytePos = sub / 8;
-
-        unsigned int visited;
-        memcpy( &visited, &aptr[bytePos], 1 );
-        return ( (visited >> (7 - offset)) & 1 );
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if ( current >= 0 )
+        {
+            seconds[current] += chrono::duration<double>(now - since).count();
+        }
+        current = kmer >> (2 * (k - p));
+        kmers[current]++;
+        since = now;
     }
-    
+
     /*
-     * Set the element indexed by sub to be visited
-     *
-     * sub : The index of the element
+     * Charges the time since the last call to enter() and stops charging
      */
-    void setVisited( const unsigned long int sub )
+    void leave()
     {
-        // Find the bit offset
-        int offset = sub % 8;
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        if ( current >= 0 )
+        {
+            seconds[current] += chrono::duration<double>(now - since).count();
+        }
+        current = -1;
+    }
 
-        // Find the byte in which the required element is located
-        unsigned long int bytePos = sub / 8;
+    /*
+     * Counts a distance calculation in the current region
+     */
+    void countDist()
+    {
+        if ( current >= 0 )
+        {
+            distCalls[current]++;
+        }
+    }
 
-        unsigned int visited = 1u << (7 - offset);
-        aptr[bytePos] = aptr[bytePos] | visited;
+    /*
+     * Counts a k-mer covered by askNeighbors in the current region
+     */
+    void countAskHit()
+    {
+        if ( current >= 0 )
+        {
+            askHits[current]++;
+        }
     }
-};
 
-/*
- * Implementation of the Simple Pairwise Comparison method with random order of
- * k-mer iteration
- *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
- */
-void doRandPairwiseCmp( const int k, const int d )
-{
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    VisitedArray visit(kmerSpaceSize);
-    vector<unsigned long int> MIS;
-    bool isCovered = false;
-    
-    cerr << "\nList of independent nodes: " << endl;
-    sleep(1);
-    srand( time(nullptr) );
-    for ( unsigned long int i = 0; i < kmerSpaceSize; ++i )
+    /*
+     * Counts a node expanded by markBall in the current region
+     */
+    void countBFSNode()
     {
-        unsigned long int count = rand() % kmerSpaceSize;
-        unsigned long int kmer;
-        bool found = false;
-        for (kmer = count; kmer < kmerSpaceSize; ++kmer)
+        if ( current >= 0 )
         {
-            if (visit[kmer] == 0)
-            {
-                found = true;
-                break;
-            }
+            bfsNodes[current]++;
         }
-        if ( !found )
+    }
+
+    /*
+     * Writes the counters to a file, one matrix per counter, and prints the
+     * most expensive region. Returns false if the file cannot be written.
+     *
+     * filename: The output file
+     */
+    bool write( const string &filename ) const
+    {
+        ofstream out(filename.c_str());
+        out << "# Costs per region of k-mers with the same first " << p 
+            << " bases, k=" << k << "\n\n";
+        writeMatrix( out, "k-mers", kmers );
+        writeMatrix( out, "seconds", seconds );
+        writeMatrix( out, "distance calculations", distCalls );
+        writeMatrix( out, "askNeighbors hits", askHits );
+        writeMatrix( out, "BFS nodes", bfsNodes );
+        if ( !out )
         {
-            for (kmer = 0; kmer < count; ++kmer)
-            {
-                if (visit[kmer] == 0)
-                {
-                    break;
-                }
-            }
+            return false;
         }
-        visit.setVisited(kmer);
-        for ( const unsigned long int &j : MIS )
+        unsigned long int worst = max_element( seconds.begin(), 
+                                               seconds.end() ) - 
+                                  seconds.begin();
+        double total = 0;
+        for ( const double &s : seconds )
         {
-            if ( editDist(kmer, j, k, d) <= d )
-            {
-                isCovered = true;
-                break;
-            }
+            total += s;
         }
-
-        if ( isCovered )
+        cerr << "The region heatmap was saved to " << filename 
+             << ". The most expensive prefix is ";
+        for (int j = p - 1; j >= 0; --j)
         {
-            isCovered = false;
-            continue;
+            cerr << "ACGT"[(worst >> (2 * j)) & 3];
         }
+        cerr << " with " << seconds[worst] << " of " << total << " sec.\n";
+        return true;
+    }
+};
 
-        printKmer( kmer, k );
-        cerr << ' ';
-        MIS.push_back( kmer );
+// The heatmap of the scan, nullptr unless --heatmap is given
+RegionHeatmap *heatmap = nullptr;
+
+/*
+ * Calculates the edit distance between 2 k-mers with the selected kernel. If 
+ * the distance exceeds d, the returned value is only guaranteed to be larger 
+ * than d.
+ *
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ * k : The length of the two k-mers
+ * d : The maximum edit distance allowed
+ */
+inline int editDist( const unsigned long int s1, const unsigned long int s2, 
+                     const int k, const int d )
+{
+    if ( heatmap != nullptr )
+    {
+        heatmap->countDist();
     }
+    return editDistKernel( s1, s2, k, d );
+}
 
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
+/*
+ * Calculates the edit distance between a candidate and an MIS member with the
+ * selected scan strategy, per pair for the deletion index. If the distance
+ * exceeds d, the returned value is only guaranteed to be larger than d.
+ *
+ * automaton: The automaton compiled from the candidate
+ * s1       : The encoding of the candidate
+ * s2       : The encoding of the MIS member
+ * k        : The length of the two k-mers
+ * d        : The maximum edit distance allowed
+ */
+inline int scanDist( const LevenshteinAutomaton &automaton, 
+                     const unsigned long int s1, const unsigned long int s2, 
+                     const int k, const int d )
+{
+    if ( scanStrategy == SCAN_AUTOMATON )
+    {
+        if ( heatmap != nullptr )
+        {
+            heatmap->countDist();
+        }
+        return automaton.dist( s2 );
+    }
+    return editDist( s1, s2, k, d );
 }
 
 /*
- * A data structure to store the mapping information for kmers. The array is 
- * chopped into subarrays to avoid failures of dynamic allocation.
+ * An index of the deletion neighborhoods of a growing set of k-mers, after 
+ * SymSpell. Two k-mers within edit distance d become equal after deleting
+ * exactly d bases from each, so a candidate is only compared against the 
+ * members that share one of its d-deletion variants. Each slot of the open
+ * addressing table packs a 32-bit fingerprint of a variant with the index of
+ * a member; a fingerprint collision only costs an extra distance calculation.
  */
-class MappingArray
+class DeletionIndex
 {
 private:
-    char **aptrs;               // An array of pointers to subarrays
-    unsigned long int size;     // The capacity of the whole array in elements
-    unsigned long int num_subs; // Number of subarrays
-    unsigned long int sub_size; // Size of a subarray in bytes
+    vector<unsigned long int> table;   // Fingerprint << 32 | member + 1
+    vector<unsigned long int> members; // The indexed k-mers
+    vector<unsigned long int> stamps;  // The last query comparing each member
+    vector<unsigned long int> hashes;  // The variant hashes of the last query
+    unsigned long int last;            // The k-mer of the last query
+    unsigned long int queries;         // The number of queries so far
+    unsigned long int used;            // The number of occupied slots
+    int k;                             // The length of the k-mers
+    int d;                             // The maximum edit distance allowed
 
-public:
     /*
-     * Constructor
+     * Collects the hashes of the variants of a k-mer after deleting a given
+     * number of bases at or after a given position
      *
-     * s: capacity of the array
+     * enc : The binary encoding of the (shortened) k-mer
+     * len : The length of the (shortened) k-mer
+     * left: The number of bases still to delete
+     * from: The first position that may be deleted
+     * out : The hashes found
      */
-    MappingArray( unsigned long int s )
+    static void collect( unsigned long int enc, int len, int left, int from,
+                         vector<unsigned long int> &out )
     {
-        sub_size = 1ul << 30;
-        num_subs = s * 8 / sub_size; // Each element occupies 8 bytes.
-        if ( (s * 8) % sub_size != 0 )
+        if ( left == 0 )
         {
-            num_subs++;
+            // The finalizer of splitmix64
+            unsigned long int h = enc;
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ul;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebul;
+            out.push_back( h ^ (h >> 31) );
+            return;
         }
-        aptrs = (char **) calloc( num_subs, sizeof(char *) );
-        for (int i = 0; i < num_subs; ++i)
+        for (int p = from; p < len; ++p)
         {
-            aptrs[i] = (char *) calloc( sub_size, 1 );
+            unsigned long int low = enc & ((1ul << (2 * p)) - 1);
+            collect( ((enc >> (2 * p + 2)) << (2 * p)) | low, len - 1, 
+                     left - 1, p, out );
         }
-        size = s;
     }
 
     /*
-     * Destructor
+     * Computes the distinct variant hashes of a k-mer into hashes
+     *
+     * enc: The binary encoding of the k-mer
      */
-    ~MappingArray()
+    void getVariants( unsigned long int enc )
     {
-        for (int i = 0; i < num_subs; ++i)
-        {
-            free( aptrs[i] );
-        }
-        free( aptrs );
+        hashes.clear();
+        collect( enc, k, d, 0, hashes );
+        sort( hashes.begin(), hashes.end() );
+        hashes.erase( unique(hashes.begin(), hashes.end()), hashes.end() );
+        last = enc;
     }
 
     /*
-     * Overload [] operator to return the mapping of the kmer indexed by sub
+     * Adds the current variant hashes of a member to the table
      *
-     * sub: The index of the element to be extract
+     * member: The index of the member
      */
-    unsigned long int operator[]( const unsigned long int &sub )
+    void addVariants( unsigned long int member )
     {
-        // Find the byte position where the required element is located
-        // Use modulo to avoid index out of range
-        unsigned long int bytePos = (sub % size) * 8;
-
-        unsigned long int m = 0;
-        memcpy( &m, &aptrs[bytePos/sub_size][bytePos%sub_size], 8);
-        return m;
+        unsigned long int mask = table.size() - 1;
+        for ( const unsigned long int &h : hashes )
+        {
+            unsigned long int slot = h & mask;
+            while ( table[slot] != 0 )
+            {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = ((h >> 32) << 32) | (member + 1);
+            used++;
+        }
     }
-    
+
+public:
     /*
-     * Set the mapping for an element indexed by sub
+     * Constructor
      *
-     * sub: The index of the element
-     * m  : The mapping of the element
+     * len    : The length of the k-mers
+     * maxDist: The maximum edit distance allowed
      */
-    void setMap( const unsigned long int sub, unsigned long int m )
+    DeletionIndex( int len, int maxDist ) : table(1ul << 16, 0), last(~0ul),
+                                            queries(0), used(0), k(len), 
+                                            d(maxDist) {}
+
+    /*
+     * Returns the number of indexed k-mers
+     */
+    unsigned long int size() const
     {
-        unsigned long int bytePos = (sub % size) * 8;
-        memcpy( &aptrs[bytePos/sub_size][bytePos%sub_size], &m, 8);
+        return members.size();
     }
-};
 
-/*
- * Asks neighbors for possible mapping. Returns true if a feasible answer is 
- * found.
- *
- * enc    : The binary encoding of the k-mer
- * k      : The length of the k-mer
- * d      : The maximum edit distance allowed
- * mapping: The mapping array
- */
-bool askNeighbors( const unsigned long int enc, const int k, const int d, 
-                   MappingArray &mapping )
-{
-    // A set to store asked neighbors
-    unordered_set<unsigned long int> asked;
+    /*
+     * Adds a k-mer to the index
+     *
+     * enc: The binary encoding of the k-mer
+     */
+    void insert( unsigned long int enc )
+    {
+        if ( enc != last )
+        {
+            getVariants( enc );
+        }
+        members.push_back( enc );
+        stamps.push_back( queries );
 
-    // A set to store checked possibilities
-    unordered_set<unsigned long int> checked;
+        // Keep the table at most half full, rebuilding it when it doubles
+        if ( 2 * (used + hashes.size()) > table.size() )
+        {
+            vector<unsigned long int> saved = hashes;
+            unsigned long int slots = table.size();
+            while ( 2 * (used + hashes.size()) > slots )
+            {
+                slots *= 2;
+            }
+            table.assign( slots, 0 );
+            used = 0;
+            for (unsigned long int m = 0; m + 1 < members.size(); ++m)
+            {
+                getVariants( members[m] );
+                addVariants( m );
+            }
+            hashes = saved;
+            last = enc;
+        }
+        addVariants( members.size() - 1 );
+    }
 
-    for ( int j = 1; j <= k; ++j )
+    /*
+     * Finds a member within distance d of a k-mer. Returns false if there is
+     * none.
+     *
+     * enc   : The binary encoding of the k-mer
+     * member: The member found
+     */
+    bool find( unsigned long int enc, unsigned long int &member )
     {
-        unsigned long int head = (enc >> (2 * j)) << (2 * j);
-        unsigned long int tail = (enc << 1 << (63 - 2 * (j - 1))) >> 
-                                 (63 - 2 * (j - 1)) >> 1;
-        for ( unsigned long int l = 0; l < 4; ++l )
+        getVariants( enc );
+        queries++;
+        unsigned long int mask = table.size() - 1;
+        for ( const unsigned long int &h : hashes )
         {
-            unsigned long int body = l << (2 * (j - 1));
-            unsigned long int node = head + body + tail;
-            if ( asked.emplace(node).second )
+            unsigned long int fingerprint = h >> 32;
+            for (unsigned long int slot = h & mask; table[slot] != 0; 
+                 slot = (slot + 1) & mask)
             {
-                unsigned long int temp = mapping[node];
-                if ( checked.emplace(temp).second && 
-                     editDist(temp, enc, k, d) <= d )
+                if ( (table[slot] >> 32) != fingerprint )
                 {
-                    mapping.setMap(enc, temp);
+                    continue;
+                }
+                unsigned long int m = (table[slot] & 0xfffffffful) - 1;
+                if ( stamps[m] == queries )
+                {
+                    continue;
+                }
+                stamps[m] = queries;
+                if ( editDist(enc, members[m], k, d) <= d )
+                {
+                    member = members[m];
                     return true;
                 }
             }
         }
+        return false;
     }
-    return false;
-}
 
-/*
- * Implementation of the heuristic method with alphabetical order of k-mer
- * iteration
- *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
- */
-void doHeuristic( const int k, const int d )
-{
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    vector<unsigned long int> MIS;
-    vector<int> da;
-    vector<int> dc;
-    vector<int> dg;
-    vector<int> dt;
+    /*
+     * Returns true if a member from a given index on is within distance d of
+     * a k-mer. Unlike find, it changes no state, so several threads may call
+     * it at once while no k-mer is inserted.
+     *
+     * enc  : The binary encoding of the k-mer
+     * first: The index of the first member to consider
+     */
+    bool covers( unsigned long int enc, unsigned long int first ) const
+    {
+        vector<unsigned long int> variants;
+        collect( enc, k, d, 0, variants );
+        unsigned long int mask = table.size() - 1;
+        for ( const unsigned long int &h : variants )
+        {
+            unsigned long int fingerprint = h >> 32;
+            for (unsigned long int slot = h & mask; table[slot] != 0; 
+                 slot = (slot + 1) & mask)
+            {
+                unsigned long int m = (table[slot] & 0xfffffffful) - 1;
+                if ( (table[slot] >> 32) == fingerprint && m >= first &&
+                     editDistKernel(enc, members[m], k, d) <= d )
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
 
-    MIS.push_back( 0 );
-    da.push_back( 0 );
-    dc.push_back( k );
-    dg.push_back( k );
-    dt.push_back( k );
-    MappingArray mapping(kmerSpaceSize / 4);
+/*
+ * Returns the CPU model name found in "/proc/cpuinfo"
+ */
+string getCpuModel()
+{
+    ifstream cpu_stream("/proc/cpuinfo", ios_base::in);
+    string line;
+    while ( getline(cpu_stream, line) )
+    {
+        if ( line.compare(0, 10, "model name") == 0 )
+        {
+            size_t pos = line.find(':');
+            if ( pos != string::npos && pos + 2 <= line.size() )
+            {
+                return line.substr(pos + 2);
+            }
+        }
+    }
+    return "unknown";
+}
 
-    cerr << "\nList of independent nodes: " << endl;
-    printKmer( 0, k );
-    cerr << ' ';
-    bool isCovered = false;
+/*
+ * Selects the fastest edit distance kernel and MIS scan strategy for the 
+ * given k and d on this machine. The choice is looked up in the profile file
+ * first; if it is not there, every kernel the CPU supports is timed on a 
+ * fixed sample of k-mer pairs (mostly unrelated pairs as seen by the greedy 
+ * scans, plus pairs within distance d), the selected kernel is timed against
+ * the automaton on a scan of the same pairs and against lookups in a 
+ * deletion index of the sampled members, and the result is appended to the
+ * profile file.
+ *
+ * k      : The length of the k-mer
+ * d      : The maximum edit distance allowed
+ * profile: The path of the profile file
+ */
+void autotune( const int k, const int d, const string &profile )
+{
+    string cpu = getCpuModel();
 
-    for (unsigned long int i = 1; i < kmerSpaceSize; ++i)
+    // Look for a cached choice, one tab-separated line per (CPU, k, d)
+    ifstream in_stream(profile.c_str(), ios_base::in);
+    string line;
+    while ( getline(in_stream, line) )
     {
-        if ( askNeighbors(i, k, d, mapping) )
+        vector<string> fields;
+        size_t start = 0;
+        size_t pos;
+        while ( (pos = line.find('\t', start)) != string::npos )
+        {
+            fields.push_back( line.substr(start, pos - start) );
+            start = pos + 1;
+        }
+        fields.push_back( line.substr(start) );
+        if ( fields.size() < 5 || fields[0] != cpu || 
+             atoi(fields[1].c_str()) != k || atoi(fields[2].c_str()) != d )
         {
             continue;
         }
-
-        int ds[] = {k, k, k, k};
-        unsigned long int temp_v = i;
-        for (int j = 0; j < k; ++j)
+        for (int i = 0; i < NUM_KERNELS; ++i)
         {
-            ds[temp_v & 3]--;
-            temp_v = temp_v >> 2;
+            for (int j = 0; j < NUM_SCANS; ++j)
+            {
+                if ( fields[3] == kernelNames[i] && 
+                     fields[4] == scanNames[j] && kernelSupported(i) )
+                {
+                    editDistKernel = kernels[i];
+                    scanStrategy = j;
+                    cerr << "Using the " << kernelNames[i] << " edit distance "
+                         << "kernel and the " << scanNames[j] << " scan from "
+                         << "the profile " << profile << ".\n";
+                    return;
+                }
+            }
         }
+    }
+    in_stream.close();
 
-        for (unsigned long int j = 0; j < MIS.size(); ++j)
+    // Build the calibration sample with a fixed linear congruential generator
+    const int num_pairs = 4096;
+    unsigned long int mask = (1ul << (2 * k)) - 1;
+    unsigned long int state = 88172645463325252ul;
+    vector<unsigned long int> s1s(num_pairs);
+    vector<unsigned long int> s2s(num_pairs);
+    for (int i = 0; i < num_pairs; ++i)
+    {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        s1s[i] = (state >> 11) & mask;
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        s2s[i] = (state >> 11) & mask;
+        if ( i % 8 == 0 )
         {
-            if ( abs(da[j] - ds[0]) > d ||
-                 abs(dc[j] - ds[1]) > d ||
-                 abs(dg[j] - ds[2]) > d ||
-                 abs(dt[j] - ds[3]) > d )
+            // Substitute at most d bases of s1
+            s2s[i] = s1s[i];
+            for (int j = 0; j < d; ++j)
             {
-                continue;
+                state = state * 6364136223846793005ul + 1442695040888963407ul;
+                int p = (state >> 33) % k;
+                s2s[i] ^= ((state >> 20) & 3) << (2 * p);
             }
-            if ( da[j] + ds[0] <= d ||
-                 dc[j] + ds[1] <= d ||
-                 dg[j] + ds[2] <= d ||
-                 dt[j] + ds[3] <= d ||
-                 editDist(i, MIS[j], k, d) <= d)
+        }
+    }
+
+    // Time every kernel, discarding the ones that disagree with the DP
+    int best = 0;
+    double best_time = 0;
+    volatile int sink = 0;
+    cerr << "Calibrating edit distance kernels for k=" << k << ", d=" << d
+         << ":";
+    for (int i = 0; i < NUM_KERNELS; ++i)
+    {
+        if ( !kernelSupported(i) )
+        {
+            cerr << ", " << kernelNames[i] << " unsupported";
+            continue;
+        }
+        bool agrees = true;
+        for (int j = 0; j < num_pairs; ++j)
+        {
+            int ref = editDistDP(s1s[j], s2s[j], k, d);
+            int res = kernels[i](s1s[j], s2s[j], k, d);
+            if ( (ref <= d || res <= d) && ref != res )
             {
-                mapping.setMap(i, MIS[j]);
-                isCovered = true;
+                agrees = false;
                 break;
             }
         }
-
-        if ( isCovered )
+        if ( !agrees )
         {
-            isCovered = false;
+            cerr << (i == 0 ? " " : ", ") << kernelNames[i] << " incorrect";
             continue;
         }
 
-        printKmer( i, k );
-        cerr << ' ';
-        MIS.push_back( i );
-        da.push_back( ds[0] );
-        dc.push_back( ds[1] );
-        dg.push_back( ds[2] );
-        dt.push_back( ds[3] );
-        mapping.setMap( i, i );
+        // Keep the fastest of a few repetitions
+        double kernel_time = 0;
+        for (int rep = 0; rep < 5; ++rep)
+        {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            for (int j = 0; j < num_pairs; ++j)
+            {
+                sink += kernels[i](s1s[j], s2s[j], k, d);
+            }
+            double t = chrono::duration<double, nano>(
+                           chrono::steady_clock::now() - t0).count();
+            if ( rep == 0 || t < kernel_time )
+            {
+                kernel_time = t;
+            }
+        }
+        kernel_time /= num_pairs;
+        cerr << (i == 0 ? " " : ", ") << kernelNames[i] << ' ' << kernel_time
+             << " ns/pair";
+        if ( i == 0 || kernel_time < best_time )
+        {
+            best = i;
+            best_time = kernel_time;
+        }
     }
+    cerr << ".\n"
+         << "Using the " << kernelNames[best] << " edit distance kernel.\n";
+    editDistKernel = kernels[best];
 
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
+    // Time scanning 64 members with 64 candidates, per pair or compiled
+    double scan_time[2] = {0, 0};
+    for (int rep = 0; rep < 5; ++rep)
+    {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int i = 0; i < num_pairs; i += 64)
+        {
+            for (int j = 0; j < 64; ++j)
+            {
+                sink += editDistKernel(s1s[i], s2s[j], k, d);
+            }
+        }
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        for (int i = 0; i < num_pairs; i += 64)
+        {
+            LevenshteinAutomaton automaton(s1s[i], k, d);
+            for (int j = 0; j < 64; ++j)
+            {
+                sink += automaton.dist(s2s[j]);
+            }
+        }
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+        double t = chrono::duration<double, nano>(t1 - t0).count();
+        if ( rep == 0 || t < scan_time[SCAN_PAIRWISE] )
+        {
+            scan_time[SCAN_PAIRWISE] = t;
+        }
+        t = chrono::duration<double, nano>(t2 - t1).count();
+        if ( rep == 0 || t < scan_time[SCAN_AUTOMATON] )
+        {
+            scan_time[SCAN_AUTOMATON] = t;
+        }
+    }
+    scanStrategy = (scan_time[SCAN_AUTOMATON] < scan_time[SCAN_PAIRWISE]) ?
+                   SCAN_AUTOMATON : SCAN_PAIRWISE;
+    cerr << "Scanning the MIS: pairwise " << scan_time[0] / num_pairs 
+         << " ns/pair, automaton " << scan_time[1] / num_pairs << " ns/pair. "
+         << "Using the " << scanNames[scanStrategy] << " scan";
+    if ( scanStrategy == SCAN_AUTOMATON )
+    {
+        cerr << ", which beats per-pair " << kernelNames[best] << " by " 
+             << scan_time[0] / scan_time[1] << "x";
+    }
+    cerr << ".\n";
+
+    // Time lookups in a deletion index of all sampled members against a full
+    // scan of them, i.e. an MIS of a few thousand members
+    DeletionIndex index(k, d);
+    for (int j = 0; j < num_pairs; ++j)
+    {
+        index.insert( s2s[j] );
+    }
+    double lookup_time = 0;
+    for (int rep = 0; rep < 5; ++rep)
+    {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int i = 0; i < num_pairs; ++i)
+        {
+            unsigned long int member;
+            sink += index.find( s1s[i], member );
+        }
+        double t = chrono::duration<double, nano>(
+                       chrono::steady_clock::now() - t0).count();
+        if ( rep == 0 || t < lookup_time )
+        {
+            lookup_time = t;
+        }
+    }
+    lookup_time /= num_pairs;
+
+    // The scan timed num_pairs pairs, as many as one candidate against all
+    // sampled members
+    double full_scan = scan_time[scanStrategy];
+    cerr << "Checking a candidate against " << num_pairs << " members: "
+         << scanNames[scanStrategy] << " scan " << full_scan << " ns, "
+         << "deletion index " << lookup_time << " ns.";
+    if ( lookup_time < full_scan )
+    {
+        scanStrategy = SCAN_DELETION;
+        cerr << " Using the deletion index.";
+    }
+    cerr << '\n';
+
+    ofstream out_stream(profile.c_str(), ios_base::app);
+    out_stream << cpu << '\t' << k << '\t' << d << '\t' << kernelNames[best]
+               << '\t' << scanNames[scanStrategy] << '\n';
+}
+
+/*
+ * Reports the time and space usage
+ *
+ * out: The stream to write the report to
+ */
+void reportPerformance( ostream &out = cerr )
+{
+    string temp;
+    unsigned long int utime, stime, vmpeak, vmhwm;
+
+    // Find time usage in "/proc/self/stat"
+    ifstream time_stream("/proc/self/stat", ios_base::in);
+
+    // Skip all irrelevant attributes
+    for (int i = 0; i < 13; ++i)
+    {
+        time_stream >> temp;
+    }
+
+    time_stream >> utime >> stime;
+    time_stream.close();
+
+    // Find space usage in "/proc/self/status"
+    ifstream space_stream("/proc/self/status", ios_base::in);
+    while ( temp.compare("VmPeak:") != 0 )
+    {
+        space_stream >> temp;
+    }
+    space_stream >> vmpeak;
+    while ( temp.compare("VmHWM:") != 0 )
+    {
+        space_stream >> temp;
+    }
+    space_stream >> vmhwm;
+    space_stream.close();
+
+    out << "Performance Report\n"
+        << "Time in user mode:        " 
+        << utime / sysconf(_SC_CLK_TCK) << " sec\n"
+        << "Time in kernel mode:      " 
+        << stime / sysconf(_SC_CLK_TCK) << " sec\n"
+        << "Peak virtual memory size: " << vmpeak << " kB\n"
+        << "Peak resident set size:   " << vmhwm << " kB\n\n";
+}
+
+/*
+ * Options passed from the command line to the drivers
+ */
+struct RunOptions
+{
+    double timeLimit;              // Wall-clock budget in seconds, 0 for none
+    string checkpointFile;         // Where an interrupted run saves its state
+    string resultFile;             // Where a completed run saves its MIS
+    string witnessFile;            // Where a completed run saves witnesses
+    string voronoiFile;            // Where it saves the nearest members
+    int numThreads;                // The threads of the parallel passes
+    bool pipeline;                 // Runs approach 1 as a pipeline
+    unsigned int seed;             // The seed of the random iteration order
+    unsigned long int blockSize;   // K-mers per block of the block order
+    unsigned long int resumeCursor;      // The iteration to resume from
+    vector<unsigned long int> resumeMIS; // The independent set to resume from
+
+    RunOptions() : timeLimit(0), checkpointFile("kmerspace.ckpt"), 
+                   numThreads(1), pipeline(false), seed(time(nullptr)), 
+                   blockSize(4096), resumeCursor(0) {}
+};
+
+// Set when a scan is stopped by the time limit
+bool scanStopped = false;
+
+/*
+ * A wall-clock budget polled by the main scans. The clock is only read every
+ * few calls to keep the check cheap in tight loops.
+ */
+class TimeBudget
+{
+private:
+    chrono::steady_clock::time_point end; // The point in time the budget ends
+    bool limited;                         // False if there is no budget
+    unsigned int calls;                   // Calls since the clock was read
+    unsigned int interval;                // Calls between clock reads
+
+public:
+    /*
+     * Constructor
+     *
+     * seconds: The budget in seconds, 0 for no budget
+     * every  : The number of calls between clock reads
+     */
+    TimeBudget( double seconds, unsigned int every = 1024 )
+    {
+        limited = seconds > 0;
+        end = chrono::steady_clock::now() + 
+              chrono::duration_cast<chrono::steady_clock::duration>(
+                  chrono::duration<double>(seconds));
+        calls = 0;
+        interval = every;
+    }
+
+    /*
+     * Returns true if the budget has run out
+     */
+    bool expired()
+    {
+        if ( !limited || ++calls < interval )
+        {
+            return false;
+        }
+        calls = 0;
+        return chrono::steady_clock::now() >= end;
+    }
+};
+
+/*
+ * Saves the state of a scan stopped by the time limit, so that it can be 
+ * resumed with --resume
+ *
+ * opts  : The options of the run
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * k     : The length of the k-mer
+ * d     : The maximum edit distance allowed
+ * cursor: The next iteration of the main scan
+ * MIS   : The current independent set
+ */
+void saveCheckpoint( const RunOptions &opts, int method, int order, int k, 
+                     int d, unsigned long int cursor, 
+                     const vector<unsigned long int> &MIS )
+{
+    MISFileHeader header;
+    header.metric = METRIC;
+    header.complete = 0;
+    header.method = method;
+    header.order = order;
+    header.k = k;
+    header.d = d;
+    header.cursor = cursor;
+    header.seed = opts.seed;
+    scanStopped = true;
+    cerr << "\nTime limit reached at iteration " << cursor << " of the scan. "
+         << "The independent set found so far is valid but not necessarily "
+         << "maximal.";
+    if ( writeMISFile(opts.checkpointFile, header, MIS) )
+    {
+        cerr << "\nThe state was saved to " << opts.checkpointFile 
+             << "; run with --resume " << opts.checkpointFile 
+             << " to continue.";
+    }
+    else
+    {
+        cerr << "\nFailed to save the state to " << opts.checkpointFile << '.';
+    }
+}
+
+/*
+ * Prints the members of a resumed independent set
+ *
+ * opts: The options of the run
+ * k   : The length of the k-mer
+ */
+void printResumed( const RunOptions &opts, int k )
+{
+    for ( const unsigned long int &m : opts.resumeMIS )
+    {
+        printMember( m, k );
+    }
+}
+
+/*
+ * An array holding one member index per k-mer with just enough bits to hold
+ * the number of members. The all-ones value marks a k-mer without a witness.
+ */
+class WitnessArray
+{
+private:
+    vector<unsigned long int> words; // The packed indices
+    int bits;                        // The bits per index
+
+public:
+    /*
+     * Constructor
+     *
+     * num_kmers  : The number of k-mers
+     * num_members: The number of members to index
+     */
+    WitnessArray( unsigned long int num_kmers, unsigned long int num_members )
+    {
+        bits = 1;
+        while ( bits < 63 && (num_members >> bits) != 0 )
+        {
+            bits++;
+        }
+        words.assign( (num_kmers * bits + 63) / 64, ~0ul );
+    }
+
+    /*
+     * Returns the value marking a k-mer without a witness
+     */
+    unsigned long int none() const
+    {
+        return (1ul << bits) - 1;
+    }
+
+    /*
+     * Returns the bits per index
+     */
+    int getBits() const
+    {
+        return bits;
+    }
+
+    /*
+     * Returns the packed indices
+     */
+    const vector<unsigned long int> &getWords() const
+    {
+        return words;
+    }
+
+    /*
+     * Overload [] operator to return the witness of a k-mer
+     *
+     * sub: The encoding of the k-mer
+     */
+    unsigned long int operator[]( const unsigned long int sub ) const
+    {
+        unsigned long int pos = sub * bits;
+        unsigned long int value = words[pos / 64] >> (pos % 64);
+        if ( pos % 64 + bits > 64 )
+        {
+            value |= words[pos / 64 + 1] << (64 - pos % 64);
+        }
+        return value & none();
+    }
+
+    /*
+     * Sets the witness of a k-mer
+     *
+     * sub   : The encoding of the k-mer
+     * member: The index of the member
+     */
+    void setWitness( const unsigned long int sub, unsigned long int member )
+    {
+        unsigned long int pos = sub * bits;
+        words[pos / 64] &= ~(none() << (pos % 64));
+        words[pos / 64] |= member << (pos % 64);
+        if ( pos % 64 + bits > 64 )
+        {
+            int low = 64 - pos % 64;
+            words[pos / 64 + 1] &= ~(none() >> low);
+            words[pos / 64 + 1] |= member >> low;
+        }
+    }
+};
+
+/*
+ * Writes the witnesses of a set to a witness file, unless some k-mer has 
+ * none. Returns true on success.
+ *
+ * filename: The output file
+ * k       : The length of the k-mer
+ * d       : The maximum edit distance allowed
+ * MIS     : The maximal independent set
+ * witness : The witnesses of all k-mers
+ */
+bool writeWitnessFile( const string &filename, int k, int d, 
+                       const vector<unsigned long int> &MIS,
+                       const WitnessArray &witness )
+{
+    unsigned long int num_kmers = 1ul << (2 * k);
+    unsigned long int missing = 0;
+    for (unsigned long int i = 0; i < num_kmers; ++i)
+    {
+        missing += witness[i] == witness.none();
+    }
+    if ( missing > 0 )
+    {
+        cerr << "\n" << missing << " k-mers are not covered, so no witness "
+             << "file was written.";
+        return false;
+    }
+
+    WitnessFileHeader header;
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, "KWIT", 4 );
+    header.version = 1;
+    header.metric = METRIC;
+    header.bits = witness.getBits();
+    header.k = k;
+    header.d = d;
+    header.size = MIS.size();
+    const vector<unsigned long int> &words = witness.getWords();
+    ofstream out_stream(filename.c_str(), ios_base::out | ios_base::binary);
+    out_stream.write( (const char *) &header, sizeof(header) );
+    out_stream.write( (const char *) MIS.data(), MIS.size() * 8 );
+    out_stream.write( (const char *) words.data(), words.size() * 8 );
+    if ( !out_stream )
+    {
+        cerr << "\nFailed to save the witnesses to " << filename << '.';
+        return false;
+    }
+    return true;
+}
+
+// Defined with the graph traversal of the third algorithm below
+void saveWitness( const string &filename, int k, int d, 
+                  const vector<unsigned long int> &MIS );
+void saveVoronoi( const string &filename, int k, int d, int numThreads,
+                  const vector<unsigned long int> &MIS );
+
+/*
+ * Saves the independent set of a completed run and its performance report to
+ * the result cache, if one is in use, and the witnesses and the Voronoi 
+ * mapping of the set if they were requested
+ *
+ * opts  : The options of the run
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * k     : The length of the k-mer
+ * d     : The maximum edit distance allowed
+ * MIS   : The maximal independent set
+ */
+void saveResult( const RunOptions &opts, int method, int order, int k, int d, 
+                 const vector<unsigned long int> &MIS )
+{
+    if ( !opts.witnessFile.empty() && !scanStopped )
+    {
+        saveWitness( opts.witnessFile, k, d, MIS );
+    }
+    if ( !opts.voronoiFile.empty() && !scanStopped )
+    {
+        saveVoronoi( opts.voronoiFile, k, d, opts.numThreads, MIS );
+    }
+    if ( opts.resultFile.empty() || scanStopped )
+    {
+        return;
+    }
+    MISFileHeader header;
+    header.metric = METRIC;
+    header.complete = 1;
+    header.method = method;
+    header.order = order;
+    header.k = k;
+    header.d = d;
+    header.cursor = 0;
+    header.seed = opts.seed;
+    if ( !writeMISFile(opts.resultFile, header, MIS) )
+    {
+        cerr << "\nFailed to save the result to " << opts.resultFile << '.';
+        return;
+    }
+    string perfFile = opts.resultFile + ".perf";
+    ofstream perf_stream(perfFile.c_str(), ios_base::out);
+    reportPerformance( perf_stream );
+    cerr << "\nThe result was saved to " << opts.resultFile << '.';
+}
+
+/*
+ * Hashes a buffer with 64-bit FNV-1a
+ *
+ * data: The buffer
+ * len : The length of the buffer in bytes
+ * hash: The hash of the preceding data, if any
+ */
+unsigned long int fnv1a( const char *data, size_t len, 
+                         unsigned long int hash = 14695981039346656037ul )
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash = (hash ^ (unsigned char) data[i]) * 1099511628211ul;
+    }
+    return hash;
+}
+
+/*
+ * Returns an identifier of this build of the program, the hash of its own
+ * executable, or of the compilation time if the executable cannot be read
+ */
+unsigned long int getBuildId()
+{
+    ifstream in_stream("/proc/self/exe", ios_base::in | ios_base::binary);
+    if ( !in_stream )
+    {
+        const char *stamp = __DATE__ " " __TIME__;
+        return fnv1a( stamp, strlen(stamp) );
+    }
+    unsigned long int hash = fnv1a( nullptr, 0 );
+    vector<char> buffer(1 << 16);
+    while ( in_stream.read(buffer.data(), buffer.size()) || 
+            in_stream.gcount() > 0 )
+    {
+        hash = fnv1a( buffer.data(), in_stream.gcount(), hash );
+    }
+    return hash;
+}
+
+/*
+ * Returns the path of the cache entry of a configuration. The name is the hash
+ * of the configuration and the build, so a rebuilt program starts afresh.
+ *
+ * dir      : The cache directory
+ * k        : The length of the k-mer
+ * d        : The maximum edit distance allowed
+ * method   : The approach chosen in main
+ * order    : The iteration order chosen in main
+ * seed     : The seed of the random iteration order, ignored for alphabetical
+ * blockSize: The block size of the block order, ignored for other orders
+ */
+string getCacheEntry( const string &dir, int k, int d, int method, int order, 
+                      unsigned int seed, unsigned long int blockSize )
+{
+    string config = string(1, METRIC) + ' ' + to_string(k) + ' ' + 
+                    to_string(d) + ' ' + to_string(method) + ' ' + 
+                    to_string(order) + ' ' + 
+                    to_string(order != 2 ? seed : 0) + ' ' + 
+                    to_string(order == 3 ? blockSize : 0) + ' ' + 
+                    to_string(getBuildId());
+    char name[32];
+    snprintf( name, sizeof(name), "%016lx.kmis", 
+              fnv1a(config.data(), config.size()) );
+    return dir + '/' + name;
+}
+
+/*
+ * Looks up a configuration in the result cache. A completed entry is printed
+ * and true is returned; a snapshot of a stopped run is loaded into the options
+ * as a warm start. Either way the run saves its state to the entry.
+ *
+ * dir   : The cache directory
+ * k     : The length of the k-mer
+ * d     : The maximum edit distance allowed
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * opts  : The options of the run
+ */
+bool lookupCache( const string &dir, int k, int d, int method, int order, 
+                  RunOptions &opts )
+{
+    mkdir( dir.c_str(), 0755 );
+    string entry = getCacheEntry( dir, k, d, method, order, opts.seed, 
+                                  opts.blockSize );
+    opts.checkpointFile = entry;
+    opts.resultFile = entry;
+
+    MISFileHeader header;
+    vector<unsigned long int> MIS;
+    if ( !readMISFile(entry, header, MIS) || header.metric != METRIC || 
+         header.k != k || header.d != d )
+    {
+        return false;
+    }
+    if ( !header.complete )
+    {
+        opts.resumeMIS = MIS;
+        opts.resumeCursor = header.cursor;
+        opts.seed = header.seed;
+        cerr << "Warm start from " << entry << " at iteration " 
+             << header.cursor << " with " << MIS.size() 
+             << " independent nodes.\n";
+        return false;
+    }
+
+    cerr << "Found the result in " << entry << ".\n";
+    cerr << "\nList of independent nodes: " << endl;
+    for ( const unsigned long int &m : MIS )
+    {
+        printMember( m, k );
+    }
+    if ( !opts.witnessFile.empty() )
+    {
+        saveWitness( opts.witnessFile, k, d, MIS );
+    }
+    if ( !opts.voronoiFile.empty() )
+    {
+        saveVoronoi( opts.voronoiFile, k, d, opts.numThreads, MIS );
+    }
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\nThe run that computed it:\n";
+    string perfFile = entry + ".perf";
+    ifstream perf_stream(perfFile.c_str(), ios_base::in);
+    cerr << perf_stream.rdbuf();
+    return true;
+}
+
+/*
+ * A block-randomized iteration order of the k-mers. The k-mers are split into
+ * blocks of consecutive encodings, the blocks are visited in a pseudo-random
+ * order, and the k-mers of each block in a pseudo-random order, so a scan
+ * touches one cache-sized region of the arrays at a time. Both permutations 
+ * are computed on the fly from the seed. A block size of 0 gives the 
+ * alphabetical order.
+ */
+class BlockOrder
+{
+private:
+    int blockBits;                // log2 of the block size
+    int totalBits;                // log2 of the number of k-mers
+    unsigned long int seed;       // The seed of the permutations
+    bool alphabetical;            // True for the identity
+
+    /*
+     * A pseudo-random bijection of the integers below 2^bits. Each round 
+     * XORs a key, multiplies by an odd constant and folds the high half into
+     * the low half, and each of these steps is invertible modulo 2^bits.
+     *
+     * x   : The integer to permute
+     * bits: The number of bits
+     * key : Selects the bijection
+     */
+    static unsigned long int permute( unsigned long int x, int bits, 
+                                      unsigned long int key )
+    {
+        if ( bits == 0 )
+        {
+            return 0;
+        }
+        unsigned long int mask = bits == 64 ? ~0ul : (1ul << bits) - 1;
+        for (int r = 0; r < 3; ++r)
+        {
+            key = key * 6364136223846793005ul + 1442695040888963407ul;
+            x = ((x ^ (key >> 11)) * ((key >> 7) | 1)) & mask;
+            x ^= x >> ((bits + 1) / 2);
+        }
+        return x;
+    }
+
+public:
+    /*
+     * Constructor
+     *
+     * num_kmers: The number of k-mers, a power of 2
+     * blockSize: The number of k-mers per block, rounded down to a power of
+     *            2, or 0 for the alphabetical order
+     * s        : The seed of the permutations
+     */
+    BlockOrder( unsigned long int num_kmers, unsigned long int blockSize, 
+                unsigned long int s ) : seed(s)
+    {
+        alphabetical = blockSize == 0;
+        totalBits = 0;
+        while ( (1ul << totalBits) < num_kmers )
+        {
+            ++totalBits;
+        }
+        blockBits = 0;
+        while ( blockBits < totalBits && (2ul << blockBits) <= blockSize )
+        {
+            ++blockBits;
+        }
+    }
+
+    /*
+     * Returns the k-mer visited at a position of the order
+     *
+     * i: The position
+     */
+    unsigned long int operator[]( unsigned long int i ) const
+    {
+        if ( alphabetical )
+        {
+            return i;
+        }
+        unsigned long int block = permute( i >> blockBits, 
+                                           totalBits - blockBits, seed );
+        unsigned long int offset = permute( i & ((1ul << blockBits) - 1), 
+                                            blockBits, seed ^ (block + 1) );
+        return (block << blockBits) | offset;
+    }
+};
+
+/*
+ * Walks the positions of an iteration order in phases, so that the work left
+ * late in a scan is proportional to the k-mers still uncovered. The first 
+ * phase walks the positions in turn. Once half of a phase has been walked, 
+ * the rest can be compacted: the caller passes a test for covered k-mers, 
+ * the threads filter contiguous slices of the remaining positions with it,
+ * and the survivors are copied to a dense array at offsets given by a prefix
+ * sum over the slice counts. The next phase walks that array. The scan still
+ * tests every k-mer it is given, since members added after a compaction 
+ * cover some of them.
+ */
+class UncoveredWalk
+{
+private:
+    const BlockOrder &order;            // The iteration order
+    vector<unsigned long int> dense;    // The positions of a compacted phase
+    bool compacted;                     // False in the first phase
+    unsigned long int end;              // The end of the current phase
+    unsigned long int cur;              // The index into the current phase
+    unsigned long int phase_start;      // The index the phase started at
+    bool started;                       // Whether next() has been called
+    int numThreads;                     // The threads of the compaction
+
+    static const unsigned long int MIN_COMPACTION = 1ul << 14;
+
+public:
+    /*
+     * Constructor
+     *
+     * o         : The iteration order
+     * begin     : The first position to walk
+     * num_kmers : The number of positions
+     * threads   : The number of threads of the compaction
+     */
+    UncoveredWalk( const BlockOrder &o, unsigned long int begin, 
+                   unsigned long int num_kmers, int threads ) 
+        : order(o), compacted(false), end(num_kmers), cur(begin), 
+          phase_start(begin), started(false), numThreads(max(1, threads)) {}
+
+    /*
+     * Moves to the next position of the walk. Returns false at the end.
+     */
+    bool next()
+    {
+        if ( started )
+        {
+            ++cur;
+        }
+        started = true;
+        return cur < end;
+    }
+
+    /*
+     * Returns the current position in the iteration order, which is also 
+     * the cursor to resume from
+     */
+    unsigned long int position() const
+    {
+        return compacted ? dense[cur] : cur;
+    }
+
+    /*
+     * Returns the k-mer at the current position
+     */
+    unsigned long int kmer() const
+    {
+        return order[position()];
+    }
+
+    /*
+     * Returns true if half of the current phase has been walked and enough
+     * of it is left to be worth compacting
+     */
+    bool compactionDue() const
+    {
+        return end - cur >= MIN_COMPACTION && 
+               cur - phase_start >= (end - phase_start) / 2;
+    }
+
+    /*
+     * Replaces the rest of the phase, the current position included, by the
+     * positions whose k-mers are not covered and starts a new phase on them.
+     * The walk then resumes with next().
+     *
+     * covered: Returns true for a covered k-mer, called from several threads
+     */
+    template <class Covered>
+    void compact( Covered covered )
+    {
+        unsigned long int left = end - cur;
+        unsigned long int slice = (left + numThreads - 1) / numThreads;
+        vector<vector<unsigned long int>> kept(numThreads);
+        vector<thread> workers;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            workers.push_back( thread([&, t]() {
+                unsigned long int lo = cur + min( left, t * slice );
+                unsigned long int hi = cur + min( left, (t + 1) * slice );
+                for (unsigned long int j = lo; j < hi; ++j)
+                {
+                    unsigned long int pos = compacted ? dense[j] : j;
+                    if ( !covered(order[pos]) )
+                    {
+                        kept[t].push_back( pos );
+                    }
+                }
+            }) );
+        }
+        for ( auto &w : workers )
+        {
+            w.join();
+        }
+
+        vector<unsigned long int> offset(numThreads + 1, 0);
+        for (int t = 0; t < numThreads; ++t)
+        {
+            offset[t + 1] = offset[t] + kept[t].size();
+        }
+        vector<unsigned long int> survivors(offset[numThreads]);
+        workers.clear();
+        for (int t = 0; t < numThreads; ++t)
+        {
+            workers.push_back( thread([&, t]() {
+                copy( kept[t].begin(), kept[t].end(), 
+                      survivors.begin() + offset[t] );
+            }) );
+        }
+        for ( auto &w : workers )
+        {
+            w.join();
+        }
+
+        dense.swap( survivors );
+        compacted = true;
+        end = dense.size();
+        cur = 0;
+        phase_start = 0;
+        started = false;
+    }
+};
+
+// Defined with the graph traversal of the third algorithm below
+template <class Container>
+void getNeighbor( unsigned long int enc, int k, Container &n );
+
+/*
+ * A bit-parallel BFS from up to 64 k-mers at once over the graph of k-mers 
+ * and (k-1)-mers of the third algorithm. Every node holds one bit per source
+ * for the sources that have reached it and one for the sources in the current
+ * frontier, so a node within reach of several sources is expanded once per 
+ * level for all of them instead of once per source. The arrays cover every 
+ * node (24 bytes each), and only the nodes touched by a run are reset, so one
+ * object serves many runs.
+ */
+class MultiSourceBFS
+{
+private:
+    vector<unsigned long int> seen;       // Sources that reached each node
+    vector<unsigned long int> visit;      // Sources in the frontier
+    vector<unsigned long int> visit_next; // Sources in the next frontier
+    vector<unsigned long int> touched;    // Nodes reached in this run
+    unsigned long int num_kmers;          // The number of k-mers
+    int k;                                // The length of the k-mers
+
+    /*
+     * Returns the array index of a node, k-mers first and then (k-1)-mers
+     *
+     * node: The node encoded as in getNeighbor
+     */
+    unsigned long int index( unsigned long int node ) const
+    {
+        return (node & 3) == 1 ? node >> 2 : num_kmers + (node >> 2);
+    }
+
+public:
+    static const int WIDTH = 64; // The number of sources per run
+
+    /*
+     * Constructor
+     *
+     * len: The length of the k-mers
+     */
+    MultiSourceBFS( int len ) : k(len)
+    {
+        num_kmers = 1ul << (2 * k);
+        seen = vector<unsigned long int>(num_kmers + num_kmers / 4, 0);
+        visit = seen;
+        visit_next = seen;
+    }
+
+    /*
+     * Returns the number of bytes of the arrays of a BFS state
+     *
+     * len: The length of the k-mers
+     */
+    static unsigned long int bytes( int len )
+    {
+        unsigned long int n = 1ul << (2 * len);
+        return 3 * (n + n / 4) * sizeof(unsigned long int);
+    }
+
+    /*
+     * Runs the BFS to depth d and calls visitor( enc, mask ) once for every
+     * k-mer within distance d of a source, the sources included, where bit i
+     * of mask is set if the k-mer is within distance d of sources[i]
+     *
+     * sources: The binary encodings of the source k-mers
+     * count  : The number of sources, at most WIDTH
+     * d      : The maximum edit distance allowed
+     * visitor: The function called for the k-mers found
+     */
+    template <class Visitor>
+    void run( const unsigned long int *sources, int count, int d, 
+              Visitor visitor )
+    {
+        vector<unsigned long int> frontier, next, neighbors;
+        for (int s = 0; s < count; ++s)
+        {
+            unsigned long int node = (sources[s] << 2) | 1;
+            unsigned long int i = index( node );
+            if ( seen[i] == 0 )
+            {
+                touched.push_back( node );
+                frontier.push_back( node );
+            }
+            seen[i] |= 1ul << s;
+            visit[i] |= 1ul << s;
+        }
+
+        for (int level = 1; level <= d && !frontier.empty(); ++level)
+        {
+            // Sources already at a node are dropped when the bits are merged
+            next.clear();
+            for ( const unsigned long int &u : frontier )
+            {
+                unsigned long int mask = visit[index(u)];
+                visit[index(u)] = 0;
+                neighbors.clear();
+                getNeighbor( u, k, neighbors );
+                for ( const unsigned long int &v : neighbors )
+                {
+                    unsigned long int i = index( v );
+                    unsigned long int reached = mask & ~seen[i];
+                    if ( reached != 0 )
+                    {
+                        if ( visit_next[i] == 0 )
+                        {
+                            next.push_back( v );
+                        }
+                        visit_next[i] |= reached;
+                    }
+                }
+            }
+            for ( const unsigned long int &v : next )
+            {
+                unsigned long int i = index( v );
+                if ( seen[i] == 0 )
+                {
+                    touched.push_back( v );
+                }
+                seen[i] |= visit_next[i];
+                visit[i] = visit_next[i];
+                visit_next[i] = 0;
+            }
+            frontier.swap( next );
+        }
+
+        for ( const unsigned long int &u : touched )
+        {
+            unsigned long int i = index( u );
+            if ( (u & 3) == 1 )
+            {
+                visitor( u >> 2, seen[i] );
+            }
+            seen[i] = 0;
+            visit[i] = 0;
+        }
+        touched.clear();
+    }
+};
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with alphabetical
+ * order of k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doPairwiseCmp( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    bool isCovered = false;
+    TimeBudget budget(opts.timeLimit);
+    DeletionIndex index(k, d);
+    if ( scanStrategy == SCAN_DELETION )
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+    
+    BlockOrder order(kmerSpaceSize, 0, 0);
+    UncoveredWalk walk(order, opts.resumeCursor, kmerSpaceSize, 
+                       opts.numThreads);
+    unsigned long int marked = 0; // The members the survivors were tested on
+    
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    while ( walk.next() )
+    {
+        unsigned long int i = walk.position();
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 1, 2, k, d, i, MIS );
+            break;
+        }
+        if ( walk.compactionDue() )
+        {
+            if ( heatmap != nullptr )
+            {
+                heatmap->leave();
+            }
+            walk.compact( [&]( unsigned long int kmer ) -> bool {
+                if ( scanStrategy == SCAN_DELETION )
+                {
+                    return index.covers( kmer, marked );
+                }
+                LevenshteinAutomaton automaton(kmer, k, d);
+                for (unsigned long int j = marked; j < MIS.size(); ++j)
+                {
+                    if ( automaton.dist(MIS[j]) <= d )
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            });
+            marked = MIS.size();
+            continue;
+        }
+        if ( heatmap != nullptr )
+        {
+            heatmap->enter( i );
+        }
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            unsigned long int member;
+            isCovered = index.find( i, member );
+        }
+        else
+        {
+            LevenshteinAutomaton automaton(i, k, d);
+            for ( const unsigned long int &j : MIS )
+            {
+                if ( scanDist(automaton, i, j, k, d) <= d )
+                {
+                    isCovered = true;
+                    break;
+                }
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( i, k );
+        MIS.push_back( i );
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            index.insert( i );
+        }
+    }
+
+    if ( heatmap != nullptr )
+    {
+        heatmap->leave();
+    }
+    saveResult( opts, 1, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * A lock-free ring buffer between one producer and one consumer thread. The
+ * producer only writes the tail and the consumer only the head, each with
+ * release order after touching a slot, so neither needs a lock.
+ */
+template <class T>
+class SpscQueue
+{
+private:
+    vector<T> slots;                          // The ring, a power of 2 long
+    unsigned long int mask;                   // The ring size minus 1
+    alignas(64) atomic<unsigned long int> head; // The next slot to read
+    alignas(64) atomic<unsigned long int> tail; // The next slot to write
+
+public:
+    /*
+     * Constructor
+     *
+     * capacity: The number of slots, a power of 2
+     */
+    SpscQueue( unsigned long int capacity ) 
+        : slots(capacity), mask(capacity - 1), head(0), tail(0) {}
+
+    /*
+     * Appends an element, called by the producer. Returns false if the 
+     * queue is full.
+     *
+     * x: The element
+     */
+    bool push( const T &x )
+    {
+        unsigned long int t = tail.load( memory_order_relaxed );
+        if ( t - head.load(memory_order_acquire) > mask )
+        {
+            return false;
+        }
+        slots[t & mask] = x;
+        tail.store( t + 1, memory_order_release );
+        return true;
+    }
+
+    /*
+     * Removes the oldest element, called by the consumer. Returns false if
+     * the queue is empty.
+     *
+     * x: Receives the element
+     */
+    bool pop( T &x )
+    {
+        unsigned long int h = head.load( memory_order_relaxed );
+        if ( h == tail.load(memory_order_acquire) )
+        {
+            return false;
+        }
+        x = slots[h & mask];
+        head.store( h + 1, memory_order_release );
+        return true;
+    }
+};
+
+/*
+ * Pushes to a queue, yielding while it is full. Returns false if the 
+ * pipeline was stopped first.
+ *
+ * q   : The queue
+ * x   : The element
+ * stop: Set when the pipeline stops
+ */
+template <class T>
+bool pushOrStop( SpscQueue<T> &q, const T &x, const atomic<bool> &stop )
+{
+    while ( !q.push(x) )
+    {
+        if ( stop.load(memory_order_relaxed) )
+        {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+/*
+ * Pops from a queue, yielding while it is empty. Returns false if the 
+ * pipeline was stopped first.
+ *
+ * q   : The queue
+ * x   : Receives the element
+ * stop: Set when the pipeline stops
+ */
+template <class T>
+bool popOrStop( SpscQueue<T> &q, T &x, const atomic<bool> &stop )
+{
+    while ( !q.pop(x) )
+    {
+        if ( stop.load(memory_order_relaxed) )
+        {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+/*
+ * Counts, for each base, the positions of a k-mer holding another base, the
+ * composition used by the filter of the second algorithm
+ *
+ * enc: The binary encoding of the k-mer
+ * k  : The length of the k-mer
+ * ds : Receives the counts for A, C, G and T
+ */
+void getComposition( unsigned long int enc, int k, int ds[4] )
+{
+    ds[0] = ds[1] = ds[2] = ds[3] = k;
+    for (int j = 0; j < k; ++j)
+    {
+        ds[enc & 3]--;
+        enc = enc >> 2;
+    }
+}
+
+/*
+ * A member of an independent set with its composition
+ */
+struct LoggedMember
+{
+    unsigned long int enc; // The binary encoding of the k-mer
+    int ds[4];             // The composition, as by getComposition
+};
+
+/*
+ * The members of an independent set as they are committed by one thread and
+ * read by others. The members are stored in chunks that never move, and the
+ * count is published with release order after a member is complete, so 
+ * readers see every member below the count they load.
+ */
+class MemberLog
+{
+private:
+    static const int CHUNK_BITS = 12;   // log2 of the members per chunk
+    vector<LoggedMember *> chunks;      // Allocated as the set grows
+    atomic<unsigned long int> count;    // The number of published members
+
+public:
+    /*
+     * Constructor
+     *
+     * capacity: The largest possible number of members
+     */
+    MemberLog( unsigned long int capacity ) 
+        : chunks((capacity >> CHUNK_BITS) + 1, nullptr), count(0) {}
+
+    /*
+     * Destructor
+     */
+    ~MemberLog()
+    {
+        for ( LoggedMember *c : chunks )
+        {
+            delete[] c;
+        }
+    }
+
+    /*
+     * Appends and publishes a member, called by one thread only
+     *
+     * enc: The binary encoding of the k-mer
+     * k  : The length of the k-mer
+     */
+    void append( unsigned long int enc, int k )
+    {
+        unsigned long int n = count.load( memory_order_relaxed );
+        LoggedMember *&chunk = chunks[n >> CHUNK_BITS];
+        if ( chunk == nullptr )
+        {
+            chunk = new LoggedMember[1ul << CHUNK_BITS];
+        }
+        LoggedMember &m = chunk[n & ((1ul << CHUNK_BITS) - 1)];
+        m.enc = enc;
+        getComposition( enc, k, m.ds );
+        count.store( n + 1, memory_order_release );
+    }
+
+    /*
+     * Returns the number of published members
+     */
+    unsigned long int size() const
+    {
+        return count.load( memory_order_acquire );
+    }
+
+    /*
+     * Returns a published member
+     *
+     * i: The index of the member
+     */
+    const LoggedMember &operator[]( unsigned long int i ) const
+    {
+        return chunks[i >> CHUNK_BITS][i & ((1ul << CHUNK_BITS) - 1)];
+    }
+};
+
+/*
+ * A k-mer passed between the stages of the pipelined scan
+ */
+struct Candidate
+{
+    unsigned long int pos;     // The position in the order, END at the end
+    unsigned long int kmer;    // The binary encoding of the k-mer
+    int ds[4];                 // The composition, as by getComposition
+    unsigned long int first;   // The first member left to verify
+    unsigned long int checked; // The members verified against are below it
+    unsigned long int stopAt;  // At the END, where the time limit stopped the
+                               // generation, or END
+};
+
+/*
+ * Returns true if a member of the log in a range is within distance d of a 
+ * candidate, using the composition filter of the second algorithm before an
+ * exact distance calculation
+ *
+ * log  : The members
+ * c    : The candidate
+ * begin: The first member to check
+ * end  : The member after the last one to check
+ * k    : The length of the k-mer
+ * d    : The maximum edit distance allowed
+ */
+bool coveredByLog( const MemberLog &log, const Candidate &c, 
+                   unsigned long int begin, unsigned long int end, 
+                   int k, int d )
+{
+    if ( begin >= end )
+    {
+        return false;
+    }
+    LevenshteinAutomaton automaton(c.kmer, k, d);
+    for (unsigned long int j = begin; j < end; ++j)
+    {
+        const LoggedMember &m = log[j];
+        if ( abs(m.ds[0] - c.ds[0]) > d || abs(m.ds[1] - c.ds[1]) > d ||
+             abs(m.ds[2] - c.ds[2]) > d || abs(m.ds[3] - c.ds[3]) > d )
+        {
+            continue;
+        }
+        if ( m.ds[0] + c.ds[0] <= d || m.ds[1] + c.ds[1] <= d ||
+             m.ds[2] + c.ds[2] <= d || m.ds[3] + c.ds[3] <= d ||
+             scanDist(automaton, c.kmer, m.enc, k, d) <= d )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with alphabetical
+ * order as a pipeline of four threads connected by SPSC queues: generation 
+ * of the k-mers in the iteration order, a composition filter that drops the
+ * k-mers it proves covered and skips the members it proves far, exact 
+ * verification of the remaining members, and the commit of new members in 
+ * order. The filter and the verification only see the members published 
+ * when they handle a k-mer, so the commit stage checks the members added 
+ * since then; k-mers reach it in order, so the set is the one of 
+ * doPairwiseCmp.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doPipelinedPairwiseCmp( const int k, const int d, 
+                             const RunOptions &opts )
+{
+    const unsigned long int END = ~0ul;
+    const unsigned long int capacity = 1024; // Candidates per queue
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    BlockOrder order(kmerSpaceSize, 0, 0);
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    MemberLog log(kmerSpaceSize);
+    for ( const unsigned long int &m : MIS )
+    {
+        log.append( m, k );
+    }
+    TimeBudget budget(opts.timeLimit);
+    SpscQueue<Candidate> generated(capacity);
+    SpscQueue<Candidate> filtered(capacity);
+    SpscQueue<Candidate> verified(capacity);
+    atomic<bool> stop(false);
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+
+    // Stage 1: generate the k-mers in the iteration order until the time
+    // limit, which is polled here since few k-mers reach the commit late in
+    // the scan
+    thread generator([&]() {
+        Candidate c;
+        c.stopAt = END;
+        for (c.pos = opts.resumeCursor; c.pos < kmerSpaceSize; ++c.pos)
+        {
+            if ( budget.expired() )
+            {
+                c.stopAt = c.pos;
+                break;
+            }
+            c.kmer = order[c.pos];
+            getComposition( c.kmer, k, c.ds );
+            if ( !pushOrStop(generated, c, stop) )
+            {
+                return;
+            }
+        }
+        c.pos = END;
+        pushOrStop( generated, c, stop );
+    });
+
+    // Stage 2: drop the k-mers the composition proves covered and skip the
+    // members it proves far, up to the first one it cannot decide
+    thread filter([&]() {
+        Candidate c;
+        while ( popOrStop(generated, c, stop) )
+        {
+            if ( c.pos != END )
+            {
+                c.checked = log.size();
+                c.first = c.checked;
+                bool covered = false;
+                for (unsigned long int j = 0; j < c.checked; ++j)
+                {
+                    const LoggedMember &m = log[j];
+                    if ( abs(m.ds[0] - c.ds[0]) > d || 
+                         abs(m.ds[1] - c.ds[1]) > d ||
+                         abs(m.ds[2] - c.ds[2]) > d || 
+                         abs(m.ds[3] - c.ds[3]) > d )
+                    {
+                        continue;
+                    }
+                    covered = m.ds[0] + c.ds[0] <= d || 
+                              m.ds[1] + c.ds[1] <= d ||
+                              m.ds[2] + c.ds[2] <= d || 
+                              m.ds[3] + c.ds[3] <= d;
+                    c.first = j;
+                    break;
+                }
+                if ( covered )
+                {
+                    continue;
+                }
+            }
+            if ( !pushOrStop(filtered, c, stop) || c.pos == END )
+            {
+                return;
+            }
+        }
+    });
+
+    // Stage 3: verify against the members left, including those published
+    // since the filter
+    thread verifier([&]() {
+        Candidate c;
+        while ( popOrStop(filtered, c, stop) )
+        {
+            if ( c.pos != END )
+            {
+                c.checked = log.size();
+                if ( coveredByLog(log, c, c.first, c.checked, k, d) )
+                {
+                    continue;
+                }
+            }
+            if ( !pushOrStop(verified, c, stop) || c.pos == END )
+            {
+                return;
+            }
+        }
+    });
+
+    // Stage 4: commit the k-mers not covered by the members added since
+    Candidate c;
+    while ( popOrStop(verified, c, stop) && c.pos != END )
+    {
+        if ( coveredByLog(log, c, c.checked, log.size(), k, d) )
+        {
+            continue;
+        }
+        printMember( c.kmer, k );
+        MIS.push_back( c.kmer );
+        log.append( c.kmer, k );
+    }
+    if ( c.pos == END && c.stopAt != END )
+    {
+        saveCheckpoint( opts, 1, 2, k, d, c.stopAt, MIS );
+    }
+    stop = true;
+    generator.join();
+    filter.join();
+    verifier.join();
+
+    saveResult( opts, 1, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with alphabetical
+ * order of k-mer iteration, tiled for cache reuse. A block of consecutive 
+ * candidates is checked against one tile of the MIS at a time, so each tile is
+ * loaded once per block instead of once per candidate. Candidates in the block
+ * that survive all tiles are then resolved in order against each other, which
+ * gives exactly the same MIS as doPairwiseCmp. The distances are computed 
+ * with the selected scan strategy; with the deletion index, which needs no
+ * tiles, each candidate is looked up in it instead.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doTiledPairwiseCmp( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    const unsigned long int block_size = 64;  // Candidates per block
+    const unsigned long int tile_size = 2048; // MIS members per tile (16 KiB)
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    bool isCovered[block_size];
+    vector<LevenshteinAutomaton> automata; // One per candidate of the block
+    automata.reserve( block_size );
+    TimeBudget budget(opts.timeLimit, 1); // Blocks are few, check each one
+    DeletionIndex index(k, d);
+    if ( scanStrategy == SCAN_DELETION )
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    for ( unsigned long int base = opts.resumeCursor; base < kmerSpaceSize; 
+          base += block_size )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 4, 2, k, d, base, MIS );
+            break;
+        }
+        unsigned long int n = kmerSpaceSize - base;
+        if ( n > block_size )
+        {
+            n = block_size;
+        }
+        unsigned long int remaining = n;
+        automata.clear();
+        for ( unsigned long int c = 0; c < n; ++c )
+        {
+            isCovered[c] = false;
+            automata.emplace_back( base + c, k, d );
+        }
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            unsigned long int member;
+            for ( unsigned long int c = 0; c < n; ++c )
+            {
+                isCovered[c] = index.find( base + c, member );
+            }
+            remaining = 0;
+        }
+
+        // Check the block against the MIS one tile at a time
+        for ( unsigned long int t = 0; t < MIS.size() && remaining > 0; 
+              t += tile_size )
+        {
+            unsigned long int tile_end = t + tile_size;
+            if ( tile_end > MIS.size() )
+            {
+                tile_end = MIS.size();
+            }
+            for ( unsigned long int c = 0; c < n; ++c )
+            {
+                if ( isCovered[c] )
+                {
+                    continue;
+                }
+                for ( unsigned long int j = t; j < tile_end; ++j )
+                {
+                    if ( scanDist(automata[c], base + c, MIS[j], k, d) <= d )
+                    {
+                        isCovered[c] = true;
+                        remaining--;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Resolve the candidates within the block in order
+        for ( unsigned long int c = 0; c < n; ++c )
+        {
+            if ( isCovered[c] )
+            {
+                continue;
+            }
+            printMember( base + c, k );
+            MIS.push_back( base + c );
+            if ( scanStrategy == SCAN_DELETION )
+            {
+                index.insert( base + c );
+            }
+            for ( unsigned long int c2 = c + 1; c2 < n; ++c2 )
+            {
+                if ( !isCovered[c2] && 
+                     scanDist(automata[c2], base + c2, base + c, k, d) <= d )
+                {
+                    isCovered[c2] = true;
+                }
+            }
+        }
+    }
+
+    saveResult( opts, 4, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * A class for the visited array used to mark if a k-mer has been visited
+ */
+class VisitedArray
+{
+private:
+    char *aptr;             // Array pointer
+    unsigned long int size; // The capacity of the whole array in elements
+
+public:
+    /*
+     * Constructor
+     *
+     * s: total number of elements
+     */
+    VisitedArray( unsigned long int s )
+    {
+        aptr = (char *) calloc( s/8, 1 ); // Each element occupies 1 bit.
+        size = s;
+    }
+
+    /*
+     * Destructor
+     */
+    ~VisitedArray()
+    {
+        free( aptr );
+    }
+
+    /*
+     * Overload [] operator to return the value indexed by sub
+     *
+     * sub: The index of the element to be extract
+     */
+    unsigned int operator[]( const unsigned long int &sub )
+    {
+        // Find the bit offset
+        int offset = sub % 8;
+
+        // Find the byte in which the required element is located
+        unsigned long int bytePos = sub / 8;
+
+        unsigned int visited;
+        memcpy( &visited, &aptr[bytePos], 1 );
+        return ( (visited >> (7 - offset)) & 1 );
+    }
+    
+    /*
+     * Set the element indexed by sub to be visited
+     *
+     * sub : The index of the element
+     */
+    void setVisited( const unsigned long int sub )
+    {
+        // Find the bit offset
+        int offset = sub % 8;
+
+        // Find the byte in which the required element is located
+        unsigned long int bytePos = sub / 8;
+
+        unsigned int visited = 1u << (7 - offset);
+        aptr[bytePos] = aptr[bytePos] | visited;
+    }
+};
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with random order of
+ * k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doRandPairwiseCmp( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    VisitedArray visit(kmerSpaceSize);
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    bool isCovered = false;
+    TimeBudget budget(opts.timeLimit);
+
+    // K-mers visited before the checkpoint but not in the MIS are covered
+    for ( const unsigned long int &m : MIS )
+    {
+        visit.setVisited(m);
+    }
+    DeletionIndex index(k, d);
+    if ( scanStrategy == SCAN_DELETION )
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+    
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    sleep(1);
+    srand( opts.seed );
+    for ( unsigned long int i = MIS.size(); i < kmerSpaceSize; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 1, 1, k, d, i, MIS );
+            break;
+        }
+        unsigned long int count = rand() % kmerSpaceSize;
+        unsigned long int kmer;
+        bool found = false;
+        for (kmer = count; kmer < kmerSpaceSize; ++kmer)
+        {
+            if (visit[kmer] == 0)
+            {
+                found = true;
+                break;
+            }
+        }
+        if ( !found )
+        {
+            for (kmer = 0; kmer < count; ++kmer)
+            {
+                if (visit[kmer] == 0)
+                {
+                    break;
+                }
+            }
+        }
+        visit.setVisited(kmer);
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            unsigned long int member;
+            isCovered = index.find( kmer, member );
+        }
+        else
+        {
+            LevenshteinAutomaton automaton(kmer, k, d);
+            for ( const unsigned long int &j : MIS )
+            {
+                if ( scanDist(automaton, kmer, j, k, d) <= d )
+                {
+                    isCovered = true;
+                    break;
+                }
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            index.insert( kmer );
+        }
+    }
+
+    saveResult( opts, 1, 1, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * A data structure to store the mapping information for kmers. The array is 
+ * chopped into subarrays to avoid failures of dynamic allocation.
+ */
+class MappingArray
+{
+private:
+    char **aptrs;               // An array of pointers to subarrays
+    unsigned long int size;     // The capacity of the whole array in elements
+    unsigned long int num_subs; // Number of subarrays
+    unsigned long int sub_size; // Size of a subarray in bytes
+
+public:
+    /*
+     * Constructor
+     *
+     * s: capacity of the array
+     */
+    MappingArray( unsigned long int s )
+    {
+        sub_size = 1ul << 30;
+        num_subs = s * 8 / sub_size; // Each element occupies 8 bytes.
+        if ( (s * 8) % sub_size != 0 )
+        {
+            num_subs++;
+        }
+        aptrs = (char **) calloc( num_subs, sizeof(char *) );
+        for (int i = 0; i < num_subs; ++i)
+        {
+            aptrs[i] = (char *) calloc( sub_size, 1 );
+        }
+        size = s;
+    }
+
+    /*
+     * Destructor
+     */
+    ~MappingArray()
+    {
+        for (int i = 0; i < num_subs; ++i)
+        {
+            free( aptrs[i] );
+        }
+        free( aptrs );
+    }
+
+    /*
+     * Overload [] operator to return the mapping of the kmer indexed by sub
+     *
+     * sub: The index of the element to be extract
+     */
+    unsigned long int operator[]( const unsigned long int &sub )
+    {
+        // Find the byte position where the required element is located
+        // Use modulo to avoid index out of range
+        unsigned long int bytePos = (sub % size) * 8;
+
+        unsigned long int m = 0;
+        memcpy( &m, &aptrs[bytePos/sub_size][bytePos%sub_size], 8);
+        return m;
+    }
+    
+    /*
+     * Set the mapping for an element indexed by sub
+     *
+     * sub: The index of the element
+     * m  : The mapping of the element
+     */
+    void setMap( const unsigned long int sub, unsigned long int m )
+    {
+        unsigned long int bytePos = (sub % size) * 8;
+        memcpy( &aptrs[bytePos/sub_size][bytePos%sub_size], &m, 8);
+    }
+};
+
+/*
+ * Asks neighbors for possible mapping. Returns true if a feasible answer is 
+ * found.
+ *
+ * enc    : The binary encoding of the k-mer
+ * k      : The length of the k-mer
+ * d      : The maximum edit distance allowed
+ * mapping: The mapping array
+ */
+bool askNeighbors( const unsigned long int enc, const int k, const int d, 
+                   MappingArray &mapping )
+{
+    // A set to store asked neighbors
+    unordered_set<unsigned long int> asked;
+
+    // A set to store checked possibilities
+    unordered_set<unsigned long int> checked;
+
+    for ( int j = 1; j <= k; ++j )
+    {
+        unsigned long int head = (enc >> (2 * j)) << (2 * j);
+        unsigned long int tail = (enc << 1 << (63 - 2 * (j - 1))) >> 
+                                 (63 - 2 * (j - 1)) >> 1;
+        for ( unsigned long int l = 0; l < 4; ++l )
+        {
+            unsigned long int body = l << (2 * (j - 1));
+            unsigned long int node = head + body + tail;
+            if ( asked.emplace(node).second )
+            {
+                unsigned long int temp = mapping[node];
+                if ( checked.emplace(temp).second && 
+                     editDist(temp, enc, k, d) <= d )
+                {
+                    if ( heatmap != nullptr )
+                    {
+                        heatmap->countAskHit();
+                    }
+                    mapping.setMap(enc, temp);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * Implementation of the heuristic method with alphabetical or block-randomized
+ * order of k-mer iteration
+ *
+ * k    : The length of the k-mer
+ * d    : The maximum edit distance allowed
+ * opts : The options of the run
+ * order: 2 for alphabetical order, 3 for block-randomized order
+ */
+void doHeuristic( const int k, const int d, const RunOptions &opts, 
+                  const int order = 2 )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    vector<unsigned long int> MIS;
+    vector<int> da;
+    vector<int> dc;
+    vector<int> dg;
+    vector<int> dt;
+    BlockOrder visit(kmerSpaceSize, order == 3 ? opts.blockSize : 0, 
+                     opts.seed);
+
+    if ( opts.resumeMIS.empty() )
+    {
+        MIS.push_back( 0 );
+    }
+    else
+    {
+        MIS = opts.resumeMIS;
+    }
+    for ( const unsigned long int &m : MIS )
+    {
+        int ds[] = {k, k, k, k};
+        unsigned long int temp_v = m;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+        da.push_back( ds[0] );
+        dc.push_back( ds[1] );
+        dg.push_back( ds[2] );
+        dt.push_back( ds[3] );
+    }
+    MappingArray mapping(kmerSpaceSize / 4);
+    for ( const unsigned long int &m : MIS )
+    {
+        mapping.setMap( m, m );
+    }
+    DeletionIndex index(k, d);
+    if ( scanStrategy == SCAN_DELETION )
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    for ( const unsigned long int &m : MIS )
+    {
+        printMember( m, k );
+    }
+    bool isCovered = false;
+
+    // K-mer 0 seeds the MIS, which makes the zero-filled mapping valid
+    unsigned long int start = order == 3 ? 0 : 1;
+    if ( !opts.resumeMIS.empty() )
+    {
+        start = opts.resumeCursor;
+    }
+    for (unsigned long int i = start; i < kmerSpaceSize; ++i)
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 2, order, k, d, i, MIS );
+            break;
+        }
+        unsigned long int kmer = visit[i];
+        if ( heatmap != nullptr )
+        {
+            heatmap->enter( kmer );
+        }
+        if ( askNeighbors(kmer, k, d, mapping) )
+        {
+            continue;
+        }
+
+        int ds[] = {k, k, k, k};
+        unsigned long int temp_v = kmer;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            unsigned long int member;
+            isCovered = index.find( kmer, member );
+            if ( isCovered )
+            {
+                mapping.setMap(kmer, member);
+            }
+        }
+        else
+        {
+            LevenshteinAutomaton automaton(kmer, k, d);
+            for (unsigned long int j = 0; j < MIS.size(); ++j)
+            {
+                if ( abs(da[j] - ds[0]) > d ||
+                     abs(dc[j] - ds[1]) > d ||
+                     abs(dg[j] - ds[2]) > d ||
+                     abs(dt[j] - ds[3]) > d )
+                {
+                    continue;
+                }
+                if ( da[j] + ds[0] <= d ||
+                     dc[j] + ds[1] <= d ||
+                     dg[j] + ds[2] <= d ||
+                     dt[j] + ds[3] <= d ||
+                     scanDist(automaton, kmer, MIS[j], k, d) <= d)
+                {
+                    mapping.setMap(kmer, MIS[j]);
+                    isCovered = true;
+                    break;
+                }
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+        da.push_back( ds[0] );
+        dc.push_back( ds[1] );
+        dg.push_back( ds[2] );
+        dt.push_back( ds[3] );
+        mapping.setMap( kmer, kmer );
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            index.insert( kmer );
+        }
+    }
+
+    if ( heatmap != nullptr )
+    {
+        heatmap->leave();
+    }
+    saveResult( opts, 2, order, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Implementation of the heuristic method with random order of k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doRandHeuristic( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    VisitedArray visit(kmerSpaceSize);
+    vector<unsigned long int> MIS;
+    vector<int> da;
+    vector<int> dc;
+    vector<int> dg;
+    vector<int> dt;
+
+    if ( opts.resumeMIS.empty() )
+    {
+        MIS.push_back( 0 );
+    }
+    else
+    {
+        MIS = opts.resumeMIS;
+    }
+    for ( const unsigned long int &m : MIS )
+    {
+        int ds[] = {k, k, k, k};
+        unsigned long int temp_v = m;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+        da.push_back( ds[0] );
+        dc.push_back( ds[1] );
+        dg.push_back( ds[2] );
+        dt.push_back( ds[3] );
+    }
+
+    sleep(1);
+    srand( opts.seed );
+    MappingArray mapping(kmerSpaceSize / 4);
+    DeletionIndex index(k, d);
+    if ( scanStrategy == SCAN_DELETION )
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    for ( const unsigned long int &m : MIS )
+    {
+        printMember( m, k );
+        visit.setVisited( m );
+        mapping.setMap( m, m );
+    }
+    bool isCovered = false;
+    for (unsigned long int i = MIS.size(); i < kmerSpaceSize; ++i)
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 2, 1, k, d, i, MIS );
+            break;
+        }
+        unsigned long int count = rand() % kmerSpaceSize;
+        unsigned long int kmer;
+        bool found = false;
+        for (kmer = count; kmer < kmerSpaceSize; ++kmer)
+        {
+            if (visit[kmer] == 0)
+            {
+                found = true;
+                break;
+            }
+        }
+        if ( !found )
+        {
+            for (kmer = 1; kmer < count; ++kmer)
+            {
+                if (visit[kmer] == 0)
+                {
+                    break;
+                }
+            }
+        }
+        visit.setVisited(kmer);
+
+        if ( askNeighbors(kmer, k, d, mapping) )
+        {
+            continue;
+        }
+
+        int ds[] = {k, k, k, k};
+        unsigned long int temp_v = kmer;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            unsigned long int member;
+            isCovered = index.find( kmer, member );
+            if ( isCovered )
+            {
+                mapping.setMap(kmer, member);
+            }
+        }
+        else
+        {
+            LevenshteinAutomaton automaton(kmer, k, d);
+            for (unsigned long int j = 0; j < MIS.size(); ++j)
+            {
+                if ( abs(da[j] - ds[0]) > d ||
+                     abs(dc[j] - ds[1]) > d ||
+                     abs(dg[j] - ds[2]) > d ||
+                     abs(dt[j] - ds[3]) > d )
+                {
+                    continue;
+                }
+                if ( da[j] + ds[0] <= d ||
+                     dc[j] + ds[1] <= d ||
+                     dg[j] + ds[2] <= d ||
+                     dt[j] + ds[3] <= d ||
+                     scanDist(automaton, kmer, MIS[j], k, d) <= d)
+                {
+                    mapping.setMap(kmer, MIS[j]);
+                    isCovered = true;
+                    break;
+                }
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+        da.push_back( ds[0] );
+        dc.push_back( ds[1] );
+        dg.push_back( ds[2] );
+        dt.push_back( ds[3] );
+        mapping.setMap( kmer, kmer );
+        if ( scanStrategy == SCAN_DELETION )
+        {
+            index.insert( kmer );
+        }
+    }
+
+    saveResult( opts, 2, 1, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * A class for the dist array used in BFS. The array is chopped into subarrays
+ * to avoid failures of dynamic allocation.
+ */
+class DistArray
+{
+private:
+    char **aptrs;               // An array of pointers to subarrays
+    unsigned long int size;     // The capacity of the whole array in elements
+    unsigned long int num_subs; // Number of subarrays
+    unsigned long int sub_size; // Size of a subarray in bytes
+    unsigned int max_d;         // Maximum edit distance allowed
+
+public:
+    /*
+     * Constructor
+     *
+     * s: total number of elements
+     */
+    DistArray( unsigned long int s, unsigned int d )
+    {
+        sub_size = 1;
+        sub_size = sub_size << 30;
+        num_subs = s / 4 / sub_size; // Each element occupies 1/4 bytes.
+        if ( (s / 4) % sub_size != 0 )
+        {
+            num_subs++;
+        }
+        aptrs = (char **) calloc( num_subs, sizeof(char *) );
+        for (int i = 0; i < num_subs; ++i)
+        {
+            aptrs[i] = (char *) calloc( sub_size, 1 );
+        }
+        size = s;
+        max_d = d;
+    }
+
+    /*
+     * Destructor
+     */
+    ~DistArray()
+    {
+        for (int i = 0; i < num_subs; ++i)
+        {
+            free( aptrs[i] );
+        }
+        free( aptrs );
+    }
+
+    /*
+     * Overload [] operator to return the dist value indexed by sub
+     *
+     * sub: The index of the element to be extract
+     */
+    unsigned int operator[]( const unsigned long int &sub )
+    {
+        // Find the bit offset
+        int offset = (sub % 4) * 2;
+
+        // Find the byte in which the required element is located
+        unsigned long int bytePos = sub / 4;
+
+        unsigned int dist;
+        memcpy( &dist, &aptrs[bytePos/sub_size][bytePos%sub_size], 1 );
+
+        dist = (dist << (24 + offset)) >> 30;
+        return dist + (max_d + 1)/2 - 1;
+    }
+    
+    /*
+     * Set the dist value for an element indexed by sub
+     *
+     * sub : The index of the element
+     * dist: The dist value of the element
+     */
+    void setDist( const unsigned long int sub, int dist )
+    {
+        dist = dist + 1 - (max_d + 1)/2;
+        if (dist < 2)
+        {
+            dist = 1;
+        }
+
+        // Find the byte in which the required element is located
+        unsigned long int bytePos = sub / 4;
+
+        // Find the bit offset
+        int offset = (sub % 4) * 2;
+
+        unsigned int tempByte;
+        memcpy( &tempByte, &aptrs[bytePos/sub_size][bytePos%sub_size], 1 );
+        unsigned int head = tempByte >> (8 - offset);
+        head = head << (8 - offset);
+        unsigned int tail = tempByte << 24 << (offset + 2);
+        tail = tail >> 24 >> (offset + 2);
+        tempByte = tempByte & (head | tail);
+        unsigned int body = dist;
+        body = body << (6 - offset);
+        tempByte = tempByte | body;
+        memcpy( &aptrs[bytePos/sub_size][bytePos%sub_size], &tempByte, 1 );
+    }
+};
+
+/*
+ * Gets neighbors of a vertex
+ *
+ * enc: The binary encoding of the k-mer
+ * k  : The length of the k-mer
+ * n  : A unordered_set to hold the neighbors, or a vector to hold them with
+ *      duplicates
+ */
+template <class Container>
+void getNeighbor( unsigned long int enc, int k, Container &n )
+{
+    unsigned long int i = enc >> 2;
+
+    // Populate the adjacency list for kmers
+    if ( (enc & 3) == 1 )
+    {
+        // Handle deletion
+        for (int j = 1; j <= k; ++j)
+        {
+            unsigned long int head = (i >> (2 * j)) << (2 * (j - 1));
+            unsigned long int tail = (i << 1 << (63 - 2 * (j - 1))) >> 
+                                     (63 - 2 * (j - 1)) >> 1;
+            n.insert( n.end(), (head + tail) << 2 );
+        }
+
+        // Handle substitution
+        for (int j = 1; j <= k; ++j)
+        {
+            unsigned long int head = (i >> (2 * j)) << (2 * j);
+            unsigned long int tail = (i << 1 << (63 - 2 * (j - 1))) >> 
+                                     (63 - 2 * (j - 1)) >> 1;
+            for (unsigned long int l = 0; l < 4; ++l)
+            {
+                unsigned long int body = l << (2 * (j - 1));
+                unsigned long int node = head + body + tail;
+                if ( node != i )
+                {
+                    n.insert( n.end(), (node << 2) | 1 );
+                }
+            }
+        }
+    }
+
+    // Populate the adjacency list for kMinus1mers
+    else
+    {
+        // Handle insertion
+        for (int j = 0; j <= k - 1; ++j)
+        {
+            unsigned long int head = (i >> (2 * j)) << (2 * (j + 1));
+            unsigned long int tail = (i << 1 << (63 - 2 * j)) >> 
+                                     (63 - 2 * j) >> 1;
+            for (unsigned long int l = 0; l < 4; ++l)
+            {
+                unsigned long int body = l << (2 * j);
+                unsigned long int node = head + body + tail;
+                n.insert( n.end(), (node << 2) | 1 );
+            }
+        }
+    }
+}
+
+/*
+ * Marks the k-mers and (k-1)-mers within distance d of a new independent node
+ * in the dist arrays by BFS
+ *
+ * enc            : The binary encoding of the independent k-mer
+ * k              : The length of the k-mer
+ * d              : The maximum edit distance allowed
+ * dist_kmer      : The dist array for k-mers
+ * dist_kMinus1mer: The dist array for (k-1)-mers
+ */
+void markBall( unsigned long int enc, int k, int d, DistArray &dist_kmer,
+               DistArray &dist_kMinus1mer )
+{
+    // Do BFS
+    vector<unsigned long int> Q; // Initialize an empty queue
+    Q.push_back( (enc << 2) | 1 );
+
+    // Keep the search history
+    unordered_map<unsigned long int, unsigned int> hist;
+    hist.emplace( (enc << 2) | 1, 0 );
+
+    dist_kmer.setDist(enc, 0);
+    while ( !Q.empty() )
+    {
+        auto q0 = hist.find( Q[0] );
+        if ( q0->second + 1 > d )
+        {
+            break;
+        }
+        if ( heatmap != nullptr )
+        {
+            heatmap->countBFSNode();
+        }
+        unordered_set<unsigned long int> neighbors;
+        getNeighbor( Q[0], k, neighbors );
+
+        if ( (Q[0] & 3) == 1 )
+        {
+            for ( auto &j : neighbors )
+            {
+                if ( hist.find(j) != hist.end() )
+                {
+                    continue;
+                }
+                unsigned int targetDist;
+                if ( (j & 3) == 1 )
+                {
+                    targetDist = dist_kmer[j >> 2];
+                    if ( targetDist == (d + 1)/2 - 1 ||
+                         (targetDist != (d + 1)/2 &&
+                          targetDist > q0->second + 1) )
+                    {
+                        dist_kmer.setDist(j >> 2, q0->second + 1);
+                        Q.push_back(j);
+                        hist.emplace( j, q0->second + 1 );
+                    }
+                }
+                else
+                {
+                    targetDist = dist_kMinus1mer[j >> 2];
+                    if ( targetDist == (d + 1)/2 - 1 ||
+                         (targetDist != (d + 1)/2 &&
+                          targetDist > q0->second + 1) )
+                    {
+                        dist_kMinus1mer.setDist(j >> 2, q0->second + 1);
+                        Q.push_back(j);
+                        hist.emplace( j, q0->second + 1 );
+                    }
+                }
+            }
+        }
+        else
+        {
+            for ( auto &j : neighbors )
+            {
+                if ( hist.find(j) != hist.end() )
+                {
+                    continue;
+                }
+                unsigned int targetDist = dist_kmer[j >> 2];
+                if ( targetDist == (d + 1)/2 - 1 || 
+                     (targetDist != (d + 1)/2 &&
+                      targetDist > q0->second + 1) )
+                {
+                    dist_kmer.setDist(j >> 2, q0->second + 1);
+                    Q.push_back(j);
+                    hist.emplace( j, q0->second + 1 );
+                }
+            }
+        }
+        Q.erase( Q.begin() );
+    }
+}
+
+/*
+ * Implementation of the BFS method with alphabetical or block-randomized order
+ * of k-mer iteration
+ *
+ * k    : The length of the k-mer
+ * d    : The maximum edit distance allowed
+ * opts : The options of the run
+ * order: 2 for alphabetical order, 3 for block-randomized order
+ */
+void doBFS( const int k, const int d, const RunOptions &opts, 
+            const int order = 2 )
+{
+    // Initialize dist arrays for BFS
+    unsigned long int num_kmers = 1ul << (2 * k);
+    DistArray dist_kmer(num_kmers, d);
+
+    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
+    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer, dist_kMinus1mer );
+    }
+    TimeBudget budget(opts.timeLimit);
+    BlockOrder visit(num_kmers, order == 3 ? opts.blockSize : 0, opts.seed);
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    UncoveredWalk walk(visit, opts.resumeCursor, num_kmers, opts.numThreads);
+    while ( walk.next() )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 3, order, k, d, walk.position(), MIS );
+            break;
+        }
+        if ( walk.compactionDue() )
+        {
+            if ( heatmap != nullptr )
+            {
+                heatmap->leave();
+            }
+            walk.compact( [&]( unsigned long int kmer ) { 
+                return dist_kmer[kmer] != (d + 1)/2 - 1; 
+            });
+            continue;
+        }
+        unsigned long int kmer = walk.kmer();
+        if ( heatmap != nullptr )
+        {
+            heatmap->enter( kmer );
+        }
+        if ( dist_kmer[kmer] != (d + 1)/2 - 1 )
+        {
+            continue;
+        }
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+
+        markBall( kmer, k, d, dist_kmer, dist_kMinus1mer );
+    }
+
+    if ( heatmap != nullptr )
+    {
+        heatmap->leave();
+    }
+    saveResult( opts, 3, order, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Implementation of the BFS method with random order of k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doRandBFS( const int k, const int d, const RunOptions &opts )
+{
+    // Initialize dist arrays for BFS
+    unsigned long int num_kmers = 1ul << (2 * k);
+    DistArray dist_kmer(num_kmers, d);
+
+    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
+    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer, dist_kMinus1mer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    sleep(1);
+    srand( opts.seed );
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    for ( unsigned long int i = 0; i < num_kmers; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 3, 1, k, d, i, MIS );
+            break;
+        }
+        unsigned long int count = rand() % num_kmers;
+        unsigned long int kmer;
+        bool found = false;
+        for (kmer = count; kmer < num_kmers; ++kmer)
+        {
+            if (dist_kmer[kmer] == (d + 1)/2 - 1)
+            {
+                found = true;
+                break;
+            }
+        }
+        if ( !found )
+        {
+            for (kmer = 0; kmer < count; ++kmer)
+            {
+                if (dist_kmer[kmer] == (d + 1)/2 - 1)
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if ( !found )
+        {
+            break;
+        }
+
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+
+        markBall( kmer, k, d, dist_kmer, dist_kMinus1mer );
+    }
+
+    saveResult( opts, 3, 1, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Checks if a k-mer is in the Tenengolts code, the q-ary analogue of the 
+ * Varshamov-Tenengolts code, for q = 4 and residues 0. With x_1..x_k the bases
+ * from left to right, a_1 = 1 and a_i = 1 if x_i >= x_(i-1) and 0 otherwise,
+ * the codewords satisfy sum (i - 1) a_i = 0 (mod k) and sum x_i = 0 (mod 4).
+ * The code corrects a single deletion, so no two codewords are within edit 
+ * distance 1.
+ *
+ * enc: The binary encoding of the k-mer
+ * k  : The length of the k-mer
+ */
+bool isTenengoltsCodeword( unsigned long int enc, int k )
+{
+    unsigned long int syndrome = 0;
+    unsigned long int sum = 0;
+    unsigned long int prev = 0;
+    for (int i = 1; i <= k; ++i)
+    {
+        unsigned long int x = (enc >> (2 * (k - i))) & 3;
+        if ( i == 1 || x >= prev )
+        {
+            syndrome += i - 1;
+        }
+        sum += x;
+        prev = x;
+    }
+    return syndrome % k == 0 && sum % 4 == 0;
+}
+
+/*
+ * Implementation of the BFS method seeded with the Tenengolts code. The 
+ * codewords are added to the MIS in alphabetical order, skipping those within
+ * distance d of a codeword added before (none for d = 1), and their balls are
+ * marked; the alphabetical BFS scan then completes the set to a maximal one.
+ * The cursor of a checkpoint counts the seeding pass first, so cursors from
+ * 4^k on are positions of the scan plus 4^k.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doVTSeededBFS( const int k, const int d, const RunOptions &opts )
+{
+    // Initialize dist arrays for BFS
+    unsigned long int num_kmers = 1ul << (2 * k);
+    DistArray dist_kmer(num_kmers, d);
+
+    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
+    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer, dist_kMinus1mer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    unsigned long int num_seeds = 0;
+    bool stopped = false;
+    if ( opts.resumeCursor < num_kmers )
+    {
+        for ( unsigned long int i = opts.resumeCursor; i < num_kmers; ++i )
+        {
+            if ( budget.expired() )
+            {
+                saveCheckpoint( opts, 5, 2, k, d, i, MIS );
+                stopped = true;
+                break;
+            }
+            if ( !isTenengoltsCodeword(i, k) || 
+                 dist_kmer[i] != (d + 1)/2 - 1 )
+            {
+                continue;
+            }
+            printMember( i, k );
+            MIS.push_back( i );
+
+            markBall( i, k, d, dist_kmer, dist_kMinus1mer );
+        }
+        num_seeds = MIS.size();
+    }
+
+    // Complete the set with the alphabetical scan
+    unsigned long int start = max( opts.resumeCursor, num_kmers ) - num_kmers;
+    for ( unsigned long int i = start; i < num_kmers && !stopped; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 5, 2, k, d, num_kmers + i, MIS );
+            break;
+        }
+        if ( dist_kmer[i] != (d + 1)/2 - 1 )
+        {
+            continue;
+        }
+        printMember( i, k );
+        MIS.push_back( i );
+
+        markBall( i, k, d, dist_kmer, dist_kMinus1mer );
+    }
+
+    if ( num_seeds > 0 )
+    {
+        cerr << "\nThe first " << num_seeds << " nodes are Tenengolts "
+             << "codewords.";
+    }
+    saveResult( opts, 5, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Collects the k-mers within edit distance d of a k-mer, excluding the k-mer
+ * itself, by BFS over the same k-mer/(k-1)-mer graph as doBFS
+ *
+ * enc : The binary encoding of the k-mer
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * ball: A vector to hold the k-mers found
+ */
+void getBall( unsigned long int enc, int k, int d, 
+              vector<unsigned long int> &ball )
+{
+    ball.clear();
+    vector<unsigned long int> Q;
+    Q.push_back( (enc << 2) | 1 );
+
+    // Keep the search history
+    unordered_map<unsigned long int, unsigned int> hist;
+    hist.emplace( (enc << 2) | 1, 0 );
+
+    for ( unsigned long int h = 0; h < Q.size(); ++h )
+    {
+        unsigned int dist = hist[Q[h]];
+        if ( dist + 1 > d )
+        {
+            break;
+        }
+        unordered_set<unsigned long int> neighbors;
+        getNeighbor( Q[h], k, neighbors );
+        for ( auto &j : neighbors )
+        {
+            if ( hist.emplace(j, dist + 1).second )
+            {
+                Q.push_back( j );
+                if ( (j & 3) == 1 )
+                {
+                    ball.push_back( j >> 2 );
+                }
+            }
+        }
+    }
+}
+
+/*
+ * The exact distance from every k-mer to the nearest member of a set and the
+ * nearest member itself (the Voronoi cell of the k-mer), computed by a level-
+ * synchronous BFS from all members at once over the graph of k-mers and 
+ * (k-1)-mers of the third algorithm, whose distances between k-mers are the
+ * edit distances. Every node holds its distance and owner packed into a 
+ * 32-bit word with the distance on top, so an atomic minimum settles ties
+ * between owners reaching a node in the same level by the smallest index, 
+ * whichever thread gets there first.
+ */
+class VoronoiMap
+{
+private:
+    vector<atomic<unsigned int>> cells; // Distance << 27 | owner, per node
+    unsigned long int num_kmers;        // The number of k-mers
+    int k;                              // The length of the k-mers
+
+    /*
+     * Returns the cell of a node, k-mers first and then (k-1)-mers
+     *
+     * node: The node encoded as in getNeighbor
+     */
+    atomic<unsigned int> &cell( unsigned long int node )
+    {
+        return cells[(node & 3) == 1 ? node >> 2 : num_kmers + (node >> 2)];
+    }
+
+public:
+    static const int OWNER_BITS = 27;
+    static const unsigned int UNSEEN = ~0u;
+
+    /*
+     * Constructor, running the BFS
+     *
+     * members   : The set, fewer than 2^27 - 1 k-mers
+     * len       : The length of the k-mers
+     * numThreads: The number of worker threads
+     */
+    VoronoiMap( const vector<unsigned long int> &members, int len, 
+                int numThreads ) : k(len)
+    {
+        num_kmers = 1ul << (2 * k);
+        cells = vector<atomic<unsigned int>>(num_kmers + num_kmers / 4);
+        for ( atomic<unsigned int> &c : cells )
+        {
+            c.store( UNSEEN, memory_order_relaxed );
+        }
+        vector<unsigned long int> frontier;
+        for (unsigned long int m = 0; m < members.size(); ++m)
+        {
+            unsigned long int node = (members[m] << 2) | 1;
+            if ( cell(node).load() == UNSEEN )
+            {
+                cell(node).store( m );
+                frontier.push_back( node );
+            }
+        }
+
+        const unsigned long int chunk = 256; // Nodes claimed at once
+        for (unsigned int level = 1; !frontier.empty(); ++level)
+        {
+            vector<vector<unsigned long int>> found(numThreads);
+            atomic<unsigned long int> next(0);
+            vector<thread> workers;
+            for (int t = 0; t < numThreads; ++t)
+            {
+                workers.push_back( thread([&, t]() {
+                    vector<unsigned long int> neighbors;
+                    unsigned long int begin;
+                    while ( (begin = next.fetch_add(chunk)) < frontier.size() )
+                    {
+                        unsigned long int end = min( begin + chunk, 
+                                                     frontier.size() );
+                        for (unsigned long int u = begin; u < end; ++u)
+                        {
+                            unsigned int owner = cell(frontier[u]).load() & 
+                                                 ((1u << OWNER_BITS) - 1);
+                            unsigned int want = (level << OWNER_BITS) | owner;
+                            neighbors.clear();
+                            getNeighbor( frontier[u], k, neighbors );
+                            for ( const unsigned long int &v : neighbors )
+                            {
+                                atomic<unsigned int> &c = cell( v );
+                                unsigned int cur = c.load();
+                                while ( want < cur && 
+                                        !c.compare_exchange_weak(cur, want) )
+                                {
+                                }
+                                if ( cur == UNSEEN )
+                                {
+                                    found[t].push_back( v );
+                                }
+                            }
+                        }
+                    }
+                }) );
+            }
+            for ( auto &w : workers )
+            {
+                w.join();
+            }
+            frontier.clear();
+            for ( const vector<unsigned long int> &f : found )
+            {
+                frontier.insert( frontier.end(), f.begin(), f.end() );
+            }
+        }
+    }
+
+    /*
+     * Returns the distance from a k-mer to the nearest member
+     *
+     * enc: The binary encoding of the k-mer
+     */
+    unsigned int dist( unsigned long int enc ) const
+    {
+        return cells[enc].load() >> OWNER_BITS;
+    }
+
+    /*
+     * Returns the index of the nearest member of a k-mer, the smallest one
+     * if several are equally near
+     *
+     * enc: The binary encoding of the k-mer
+     */
+    unsigned long int owner( unsigned long int enc ) const
+    {
+        return cells[enc].load() & ((1u << OWNER_BITS) - 1);
+    }
+};
+
+/*
+ * Computes the Voronoi mapping of an MIS, i.e. the nearest member of every
+ * k-mer, prints the covering radius (the largest distance from a k-mer to the
+ * MIS), the number of k-mers per distance and the sizes of the cells, and 
+ * saves the mapping as a witness file.
+ *
+ * filename  : The output file
+ * k         : The length of the k-mer
+ * d         : The maximum edit distance allowed
+ * numThreads: The number of worker threads
+ * MIS       : The maximal independent set
+ */
+void saveVoronoi( const string &filename, int k, int d, int numThreads,
+                  const vector<unsigned long int> &MIS )
+{
+    if ( MIS.size() >= (1ul << VoronoiMap::OWNER_BITS) - 1 )
+    {
+        cerr << "\nThe set is too large for the Voronoi mapping.";
+        return;
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    VoronoiMap voronoi(MIS, k, numThreads);
+    double seconds = chrono::duration<double>(
+                         chrono::steady_clock::now() - start).count();
+
+    unsigned long int num_kmers = 1ul << (2 * k);
+    WitnessArray witness(num_kmers, MIS.size());
+    vector<unsigned long int> histogram;
+    vector<unsigned long int> cell_size(MIS.size(), 0);
+    for (unsigned long int i = 0; i < num_kmers; ++i)
+    {
+        unsigned int dist = voronoi.dist( i );
+        if ( dist >= histogram.size() )
+        {
+            histogram.resize( dist + 1, 0 );
+        }
+        histogram[dist]++;
+        cell_size[voronoi.owner(i)]++;
+        witness.setWitness( i, voronoi.owner(i) );
+    }
+
+    cerr << "\nThe covering radius is " << histogram.size() - 1 
+         << " (computed with " << numThreads << " threads in " << seconds 
+         << " sec). K-mers per distance:";
+    for (unsigned long int r = 0; r < histogram.size(); ++r)
+    {
+        cerr << ' ' << r << ':' << histogram[r];
+    }
+    cerr << ". Voronoi cells hold " 
+         << *min_element( cell_size.begin(), cell_size.end() ) << " to " 
+         << *max_element( cell_size.begin(), cell_size.end() ) 
+         << " k-mers.";
+    if ( writeWitnessFile(filename, k, d, MIS, witness) )
+    {
+        cerr << "\nThe Voronoi mapping was saved to " << filename << '.';
+    }
+}
+
+/*
+ * Saves a witness for every k-mer: the first member, in the order of the MIS,
+ * within distance d of it. A verifier can then check maximality with one
+ * distance calculation per k-mer (misSetOps --verify). The balls of the 
+ * members are walked 64 at a time by a multi-source BFS.
+ *
+ * filename: The output file
+ * k       : The length of the k-mer
+ * d       : The maximum edit distance allowed
+ * MIS     : The maximal independent set
+ */
+void saveWitness( const string &filename, int k, int d, 
+                  const vector<unsigned long int> &MIS )
+{
+    WitnessArray witness(1ul << (2 * k), MIS.size());
+    MultiSourceBFS bfs(k);
+    const unsigned long int width = MultiSourceBFS::WIDTH;
+    for (unsigned long int b = 0; b < MIS.size(); b += width)
+    {
+        int count = min( MIS.size() - b, width );
+        bfs.run( &MIS[b], count, d, 
+                 [&]( unsigned long int x, unsigned long int mask ) {
+            if ( witness[x] == witness.none() )
+            {
+                witness.setWitness( x, b + __builtin_ctzl(mask) );
+            }
+        });
+    }
+    if ( writeWitnessFile(filename, k, d, MIS, witness) )
+    {
+        cerr << "\nThe witnesses were saved to " << filename << " (" 
+             << witness.getBits() << " bits per k-mer).";
+    }
+}
+
+/*
+ * A hierarchy of representatives for coarse-to-fine nearest-representative 
+ * search. Level 0 is a maximal independent set of all k-mers at radius d, and
+ * each higher level is a maximal independent set of the level below at twice
+ * the radius of that level. Every representative points to its nearest
+ * representative on the next level and records the largest distance to the
+ * level-0 representatives below it, which bounds the search.
+ */
+class RepHierarchy
+{
+private:
+    int k;                                    // The length of the k-mers
+    vector<int> radius;                       // The radius of each level
+    vector<vector<unsigned long int>> reps;   // The representatives per level
+    vector<vector<int>> cover;                // The covering radius of each
+    vector<vector<vector<unsigned long int>>> children; // The level below
+
+    /*
+     * Searches the subtrees of some representatives for a level-0 
+     * representative closer than the best found so far. The distance to a
+     * representative minus its covering radius bounds the distance to every
+     * level-0 representative below it, so subtrees are visited in the order
+     * of that bound until it reaches the best distance.
+     *
+     * query   : The k-mer compiled into an automaton
+     * l       : The level of the representatives
+     * nodes   : The indices of the representatives on that level
+     * best    : The best representative found so far
+     * dist    : The edit distance to the best representative
+     * compared: Incremented by the number of distance calculations
+     */
+    void search( const LevenshteinAutomaton &query, int l, 
+                 const vector<unsigned long int> &nodes, 
+                 unsigned long int &best, int &dist, 
+                 unsigned long int &compared ) const
+    {
+        vector<pair<int, unsigned long int>> bounds;
+        for ( const unsigned long int &j : nodes )
+        {
+            ++compared;
+            int cap = min( dist - 1 + cover[l][j], k );
+            int bound = query.dist(reps[l][j], cap) - cover[l][j];
+            if ( bound < dist )
+            {
+                bounds.push_back( make_pair(bound, j) );
+            }
+        }
+        sort( bounds.begin(), bounds.end() );
+
+        for ( const pair<int, unsigned long int> &b : bounds )
+        {
+            if ( b.first >= dist )
+            {
+                break;
+            }
+            if ( l == 0 )
+            {
+                dist = b.first;
+                best = reps[0][b.second];
+            }
+            else
+            {
+                search( query, l - 1, children[l - 1][b.second], best, dist,
+                        compared );
+            }
+        }
+    }
+
+public:
+    /*
+     * Constructor. Levels are added until the top level has at most maxTop
+     * representatives or the radius reaches k.
+     *
+     * base  : The maximal independent set at the bottom level
+     * len   : The length of the k-mers
+     * d     : The radius of the bottom level
+     * maxTop: The largest size of the top level
+     */
+    RepHierarchy( const vector<unsigned long int> &base, int len, int d, 
+                  unsigned long int maxTop = 16 )
+    {
+        k = len;
+        radius.push_back( d );
+        reps.push_back( base );
+        cover.push_back( vector<int>(base.size(), 0) );
+        vector<vector<unsigned long int>> parent;
+        while ( reps.back().size() > maxTop && 2 * radius.back() < k )
+        {
+            int r = 2 * radius.back();
+            const vector<unsigned long int> &below = reps.back();
+
+            // Greedy MIS of the level below at radius r
+            vector<unsigned long int> level;
+            for ( const unsigned long int &x : below )
+            {
+                bool isCovered = false;
+                for ( const unsigned long int &y : level )
+                {
+                    if ( editDist(x, y, k, r) <= r )
+                    {
+                        isCovered = true;
+                        break;
+                    }
+                }
+                if ( !isCovered )
+                {
+                    level.push_back( x );
+                }
+            }
+
+            // The level below is covered, so every node has a parent within r
+            vector<unsigned long int> up(below.size());
+            vector<vector<unsigned long int>> down(level.size());
+            for (unsigned long int i = 0; i < below.size(); ++i)
+            {
+                int best = r + 1;
+                for (unsigned long int j = 0; j < level.size(); ++j)
+                {
+                    int dist = editDist( below[i], level[j], k, best - 1 );
+                    if ( dist < best )
+                    {
+                        best = dist;
+                        up[i] = j;
+                    }
+                }
+                down[up[i]].push_back( i );
+            }
+
+            parent.push_back( up );
+            children.push_back( down );
+            radius.push_back( r );
+            reps.push_back( level );
+            cover.push_back( vector<int>(level.size(), 0) );
+        }
+
+        // Walk up from every level-0 representative to its ancestors
+        for (unsigned long int i = 0; i < base.size(); ++i)
+        {
+            unsigned long int a = i;
+            for (unsigned int l = 1; l < reps.size(); ++l)
+            {
+                a = parent[l - 1][a];
+                cover[l][a] = max( cover[l][a], 
+                                   editDist(base[i], reps[l][a], k, k) );
+            }
+        }
+    }
+
+    /*
+     * Returns the number of levels
+     */
+    int numLevels() const
+    {
+        return reps.size();
+    }
+
+    /*
+     * Returns the radius of a level
+     *
+     * level: The level, 0 for the bottom
+     */
+    int getRadius( int level ) const
+    {
+        return radius[level];
+    }
+
+    /*
+     * Returns the representatives of a level
+     *
+     * level: The level, 0 for the bottom
+     */
+    const vector<unsigned long int> &getReps( int level ) const
+    {
+        return reps[level];
+    }
+
+    /*
+     * Finds the nearest level-0 representative of a k-mer by descending the
+     * hierarchy from the top level. Returns the representative.
+     *
+     * query   : The encoding of the k-mer
+     * dist    : Set to the edit distance to the representative
+     * compared: Incremented by the number of distance calculations
+     */
+    unsigned long int nearest( unsigned long int query, int &dist, 
+                               unsigned long int &compared ) const
+    {
+        int top = reps.size() - 1;
+        vector<unsigned long int> nodes(reps[top].size());
+        for (unsigned long int j = 0; j < nodes.size(); ++j)
+        {
+            nodes[j] = j;
+        }
+
+        // Level 0 is maximal, so a representative is within its radius
+        unsigned long int best = 0;
+        dist = radius[0] + 1;
+        LevenshteinAutomaton automaton(query, k, k);
+        search( automaton, top, nodes, best, dist, compared );
+        return best;
+    }
+};
+
+/*
+ * A cache of the answers to recent queries of fixed capacity, evicting the 
+ * least recently used answer
+ */
+class LRUCache
+{
+private:
+    typedef list<pair<unsigned long int, unsigned long int>> EntryList;
+
+    unsigned long int capacity; // The largest number of answers kept
+    EntryList entries;          // The answers, the most recent first
+    unordered_map<unsigned long int, EntryList::iterator> index; // By query
+
+public:
+    /*
+     * Constructor
+     *
+     * c: The capacity of the cache
+     */
+    LRUCache( unsigned long int c ) : capacity(c) {}
+
+    /*
+     * Looks up the answer to a query. Returns true if it is cached.
+     *
+     * key  : The query
+     * value: Set to the answer if it is cached
+     */
+    bool get( unsigned long int key, unsigned long int &value )
+    {
+        unordered_map<unsigned long int, EntryList::iterator>::iterator it =
+            index.find( key );
+        if ( it == index.end() )
+        {
+            return false;
+        }
+        entries.splice( entries.begin(), entries, it->second );
+        value = it->second->second;
+        return true;
+    }
+
+    /*
+     * Caches the answer to a query that is not cached yet
+     *
+     * key  : The query
+     * value: The answer
+     */
+    void put( unsigned long int key, unsigned long int value )
+    {
+        if ( entries.size() == capacity )
+        {
+            index.erase( entries.back().first );
+            entries.pop_back();
+        }
+        entries.push_front( make_pair(key, value) );
+        index[key] = entries.begin();
+    }
+};
+
+/*
+ * Finds a covering MIS member of any k-mer without a mapping array, using a
+ * deletion index of the MIS and an LRU cache of recent answers. The memory is
+ * proportional to the size of the MIS and the cache.
+ */
+class RepLookup
+{
+private:
+    DeletionIndex index;    // The index of the MIS
+    LRUCache cache;         // The recent answers
+    unsigned long int hits; // Queries answered by the cache
+
+public:
+    /*
+     * Constructor
+     *
+     * MIS      : The maximal independent set
+     * k        : The length of the k-mers
+     * d        : The maximum edit distance allowed
+     * cacheSize: The capacity of the cache
+     */
+    RepLookup( const vector<unsigned long int> &MIS, int k, int d, 
+               unsigned long int cacheSize ) : 
+        index(k, d), cache(cacheSize), hits(0)
+    {
+        for ( const unsigned long int &m : MIS )
+        {
+            index.insert( m );
+        }
+    }
+
+    /*
+     * Returns an MIS member that covers a k-mer
+     *
+     * query: The encoding of the k-mer
+     */
+    unsigned long int find( unsigned long int query )
+    {
+        unsigned long int rep;
+        if ( cache.get(query, rep) )
+        {
+            ++hits;
+            return rep;
+        }
+        if ( !index.find(query, rep) )
+        {
+            rep = ~0ul;
+        }
+        cache.put( query, rep );
+        return rep;
+    }
+
+    /*
+     * Returns the number of queries answered by the cache
+     */
+    unsigned long int getHits() const
+    {
+        return hits;
+    }
+};
+
+/*
+ * Benchmarks the mapping-free lookup against a full mapping array on the 
+ * k-mers at random positions of a random sequence, so that k-mers recur like
+ * they do in sequencing data
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * MIS : The maximal independent set
+ * seed: The seed of the random sequence
+ */
+void benchmarkLookup( const int k, const int d, 
+                      const vector<unsigned long int> &MIS, unsigned int seed )
+{
+    const unsigned long int seq_len = 50000;
+    const unsigned long int num_queries = 200000;
+    const unsigned long int cache_size = 1ul << 16;
+
+    srand( seed );
+    vector<unsigned long int> seq(seq_len);
+    for ( unsigned long int &b : seq )
+    {
+        b = rand() % 4;
+    }
+    vector<unsigned long int> queries(num_queries);
+    for ( unsigned long int &q : queries )
+    {
+        unsigned long int pos = rand() % (seq_len - k + 1);
+        q = 0;
+        for (int j = 0; j < k; ++j)
+        {
+            q = (q << 2) | seq[pos + j];
+        }
+    }
+
+    // Each k-mer is mapped to the first MIS member covering it
+    unsigned long int num_kmers = 1ul << (2 * k);
+    MappingArray mapping(num_kmers);
+    MultiSourceBFS bfs(k);
+    const unsigned long int width = MultiSourceBFS::WIDTH;
+    for (unsigned long int batch = (MIS.size() + width - 1) / width; 
+         batch-- > 0; )
+    {
+        unsigned long int b = batch * width;
+        int count = min( MIS.size() - b, width );
+        bfs.run( &MIS[b], count, d, 
+                 [&]( unsigned long int x, unsigned long int mask ) {
+            mapping.setMap( x, MIS[b + __builtin_ctzl(mask)] );
+        });
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned long int checksum = 0;
+    for ( const unsigned long int &q : queries )
+    {
+        checksum += mapping[q];
+    }
+    double array_time = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+
+    RepLookup lookup(MIS, k, d, cache_size);
+    unsigned long int uncovered = 0;
+    start = chrono::steady_clock::now();
+    for ( const unsigned long int &q : queries )
+    {
+        checksum += lookup.find( q );
+    }
+    double lookup_time = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    unsigned long int hits = lookup.getHits();
+    for ( const unsigned long int &q : queries )
+    {
+        if ( editDist(q, lookup.find(q), k, d) > d )
+        {
+            ++uncovered;
+        }
+    }
+
+    cerr << "Lookup of " << num_queries << " k-mers of a random sequence of "
+         << "length " << seq_len << " (checksum " << checksum % 1000 << "):\n"
+         << "Mapping array:    " << array_time * 1e9 / num_queries 
+         << " ns per lookup, " << num_kmers * 8 / 1024 << " kB\n"
+         << "Mapping-free:     " << lookup_time * 1e9 / num_queries 
+         << " ns per lookup, " << hits * 100.0 / num_queries
+         << "% cache hits\n"
+         << "Queries not covered by their answer: " << uncovered << "\n";
+}
+
+/*
+ * Builds a hierarchy of representatives on top of the MIS found by the BFS 
+ * method with alphabetical order, then measures nearest-representative 
+ * queries on random k-mers against a scan of the whole bottom level.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doHierarchy( const int k, const int d, const RunOptions &opts )
+{
+    // Initialize dist arrays for BFS
+    unsigned long int num_kmers = 1ul << (2 * k);
+    DistArray dist_kmer(num_kmers, d);
+
+    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
+    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer, dist_kMinus1mer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    for ( unsigned long int i = opts.resumeCursor; i < num_kmers; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 6, 2, k, d, i, MIS );
+            cerr << "\nThe graph has an independent set of size " 
+                 << MIS.size() << ".\n\n";
+            reportPerformance();
+            return;
+        }
+        if ( dist_kmer[i] != (d + 1)/2 - 1 )
+        {
+            continue;
+        }
+        printMember( i, k );
+        MIS.push_back( i );
+
+        markBall( i, k, d, dist_kmer, dist_kMinus1mer );
+    }
+    saveResult( opts, 6, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n";
+
+    RepHierarchy hierarchy(MIS, k, d);
+    for (int l = 0; l < hierarchy.numLevels(); ++l)
+    {
+        cerr << "Level " << l << ": " << hierarchy.getReps(l).size() 
+             << " representatives at radius " << hierarchy.getRadius(l) 
+             << ".\n";
+    }
+
+    // Queries are checked against the exact nearest distance
+    const unsigned long int num_queries = 1000;
+    unsigned long int compared = 0;
+    unsigned long int mismatches = 0;
+    srand( opts.seed );
+    for (unsigned long int q = 0; q < num_queries; ++q)
+    {
+        unsigned long int query = ((unsigned long int) rand() << 31 | rand()) 
+                                  % num_kmers;
+        int dist;
+        hierarchy.nearest( query, dist, compared );
+        int exact = d + 1;
+        for ( const unsigned long int &m : MIS )
+        {
+            exact = min( exact, editDist(query, m, k, exact - 1) );
+        }
+        if ( dist != exact )
+        {
+            ++mismatches;
+        }
+    }
+    cerr << "Nearest-representative queries compare against " 
+         << (double) compared / num_queries << " representatives on average "
+         << "instead of " << MIS.size() << "; " << mismatches << " of " 
+         << num_queries << " differ from the exact search.\n";
+    benchmarkLookup( k, d, MIS, opts.seed );
+    cerr << '\n';
+    reportPerformance();
+}
+
+/*
+ * Walks the balls of radius d around consecutive k-mers with one run of a
+ * multi-source BFS and calls visitor( x, v ) for every k-mer x within 
+ * distance d of a source v, excluding x == v
+ *
+ * bfs    : The BFS state, for k-mers of the length of the sources
+ * first  : The binary encoding of the first source
+ * count  : The number of sources, at most MultiSourceBFS::WIDTH
+ * d      : The maximum edit distance allowed
+ * visitor: The function called for the pairs found
+ */
+template <class Visitor>
+void walkBalls( MultiSourceBFS &bfs, unsigned long int first, 
+                unsigned long int count, int d, Visitor visitor )
+{
+    unsigned long int sources[MultiSourceBFS::WIDTH];
+    for (unsigned long int s = 0; s < count; ++s)
+    {
+        sources[s] = first + s;
+    }
+    bfs.run( sources, count, d, 
+             [&]( unsigned long int x, unsigned long int mask ) {
+        if ( x - first < count )
+        {
+            mask &= ~(1ul << (x - first));
+        }
+        for ( ; mask != 0; mask &= mask - 1 )
+        {
+            visitor( x, first + __builtin_ctzl(mask) );
+        }
+    });
+}
+
+/*
+ * Builds the graph of all k-mers with an edge between every two k-mers within
+ * edit distance d in CSR form and writes it to a file in the binary graph 
+ * format read by ParHIP/KaMIS (METIS adjacency structure). The file consists
+ * of 8-byte little-endian integers: version (3), number of vertices n, number
+ * of directed edges m, n+1 vertex offsets given as byte positions in the file,
+ * and the m 0-based neighbor ids. Vertex ids are the k-mer encodings.
+ *
+ * The CSR arrays are built in two parallel passes over the k-mers, counting 
+ * the degrees first and filling the adjacency lists after a prefix sum, each
+ * walking the balls of 64 consecutive k-mers with one multi-source BFS.
+ * Returns the number of edges, or 0 if the graph does not fit in memory.
+ *
+ * k         : The length of the k-mer
+ * d         : The maximum edit distance allowed
+ * filename  : The output file
+ * numThreads: The number of worker threads, fewer if their BFS states do not
+ *             fit in memory
+ */
+unsigned long int exportGraph( const int k, const int d, 
+                               const string &filename, const int numThreads )
+{
+    unsigned long int n = 1ul << (2 * k);
+    const unsigned long int chunk = 1024; // K-mers claimed by a thread at once
+    const unsigned long int width = MultiSourceBFS::WIDTH;
+
+    // Every thread holds a full BFS state, so run only as many as fit next to
+    // the offsets in at most half of physical memory
+    unsigned long int mem = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    unsigned long int state = MultiSourceBFS::bytes( k );
+    if ( (n + 1) * 8 + state > mem / 2 )
+    {
+        cerr << "The BFS state needs " << state / 1024 << " kB per thread, "
+             << "which does not fit in memory.\n";
+        return 0;
+    }
+    int threads = numThreads;
+    if ( (unsigned long int) threads > (mem / 2 - (n + 1) * 8) / state )
+    {
+        threads = (mem / 2 - (n + 1) * 8) / state;
+        cerr << "Running " << threads << " threads, as many as the BFS states "
+             << "fit in memory.\n";
+    }
+    vector<unsigned long int> xadj(n + 1, 0);
+    atomic<unsigned long int> next(0);
+
+    // Pass 1: count the degree of every k-mer
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.push_back( thread([&]() {
+            MultiSourceBFS bfs(k);
+            unsigned long int begin;
+            while ( (begin = next.fetch_add(chunk)) < n )
+            {
+                unsigned long int end = (begin + chunk < n) ? begin + chunk : n;
+                for ( unsigned long int u = begin; u < end; u += width )
+                {
+                    walkBalls( bfs, u, min(end - u, width), d,
+                               [&]( unsigned long int, unsigned long int v ) {
+                        xadj[v + 1]++;
+                    });
+                }
+            }
+        }) );
+    }
+    for ( auto &w : workers )
+    {
+        w.join();
+    }
+    for ( unsigned long int u = 0; u < n; ++u )
+    {
+        xadj[u + 1] += xadj[u];
+    }
+    unsigned long int m = xadj[n];
+
+    // Make sure the adjacency array fits in memory next to the BFS states
+    if ( (n + 1 + m) * 8 + threads * state > mem / 2 )
+    {
+        cerr << "The graph has " << m << " directed edges and needs "
+             << ((n + 1 + m) * 8 + threads * state) / 1024 << " kB with the "
+             << "BFS states, which does not fit in memory.\n";
+        return 0;
+    }
+
+    // Pass 2: fill the adjacency lists, sorted by neighbor id
+    vector<unsigned long int> adjncy(m);
+    next = 0;
+    workers.clear();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.push_back( thread([&]() {
+            MultiSourceBFS bfs(k);
+            vector<unsigned long int> fill(chunk);
+            unsigned long int begin;
+            while ( (begin = next.fetch_add(chunk)) < n )
+            {
+                unsigned long int end = (begin + chunk < n) ? begin + chunk : n;
+                copy( xadj.begin() + begin, xadj.begin() + end, fill.begin() );
+                for ( unsigned long int u = begin; u < end; u += width )
+                {
+                    walkBalls( bfs, u, min(end - u, width), d,
+                               [&]( unsigned long int x, unsigned long int v ) {
+                        adjncy[fill[v - begin]++] = x;
+                    });
+                }
+                for ( unsigned long int u = begin; u < end; ++u )
+                {
+                    sort( adjncy.begin() + xadj[u], 
+                          adjncy.begin() + xadj[u + 1] );
+                }
+            }
+        }) );
+    }
+    for ( auto &w : workers )
+    {
+        w.join();
+    }
+
+    // Write the header, the offsets in bytes, and the edges
+    ofstream out_stream(filename.c_str(), ios_base::out | ios_base::binary);
+    unsigned long int header[3] = {3, n, m};
+    out_stream.write( (char *) header, sizeof(header) );
+    unsigned long int edge_start = (3 + n + 1) * 8;
+    for ( unsigned long int u = 0; u <= n; ++u )
+    {
+        unsigned long int offset = edge_start + xadj[u] * 8;
+        out_stream.write( (char *) &offset, 8 );
+    }
+    out_stream.write( (char *) adjncy.data(), m * 8 );
+    out_stream.close();
+
+    cerr << "Wrote the graph with " << n << " vertices and " << m / 2 
+         << " edges to " << filename << ".\n\n";
+    reportPerformance();
+    return m / 2;
+}
+
+/*
+ * A parallel engine measured by the scaling benchmark. It computes a result
+ * for k, d and a number of threads and returns a summary of the result that
+ * must not depend on the number of threads, such as the size of an MIS.
+ */
+struct ScalingEngine
+{
+    const char *name; // The name in the CSV output
+    unsigned long int (*run)( int k, int d, int numThreads );
+};
+
+/*
+ * Runs the graph export as a scaling engine, discarding the graph
+ *
+ * k         : The length of the k-mer
+ * d         : The maximum edit distance allowed
+ * numThreads: The number of worker threads
+ */
+unsigned long int runGraphEngine( int k, int d, int numThreads )
+{
+    return exportGraph( k, d, "/dev/null", numThreads );
 }
 
 /*
- * Implementation of the heuristic method with random order of k-mer iteration
+ * Runs the Voronoi BFS as a scaling engine from the Tenengolts code, which
+ * needs no MIS run. Returns the sum of the distances and owners of all 
+ * k-mers.
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k         : The length of the k-mer
+ * d         : Unused, the distances do not depend on it
+ * numThreads: The number of worker threads
  */
-void doRandHeuristic( const int k, const int d )
+unsigned long int runVoronoiEngine( int k, int /* d */, int numThreads )
 {
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    VisitedArray visit(kmerSpaceSize);
-    vector<unsigned long int> MIS;
-    vector<int> da;
-    vector<int> dc;
-    vector<int> dg;
-    vector<int> dt;
+    vector<unsigned long int> code;
+    for (unsigned long int i = 0; i < (1ul << (2 * k)); ++i)
+    {
+        if ( isTenengoltsCodeword(i, k) )
+        {
+            code.push_back( i );
+        }
+    }
+    VoronoiMap voronoi(code, k, numThreads);
+    unsigned long int sum = 0;
+    for (unsigned long int i = 0; i < (1ul << (2 * k)); ++i)
+    {
+        sum += voronoi.dist( i ) + voronoi.owner( i );
+    }
+    return sum;
+}
 
-    MIS.push_back( 0 );
-    da.push_back( 0 );
-    dc.push_back( k );
-    dg.push_back( k );
-    dt.push_back( k );
+// The engines measured by the scaling benchmark
+const int NUM_ENGINES = 2;
+ScalingEngine engines[NUM_ENGINES] = {{"export-graph", runGraphEngine},
+                                      {"voronoi", runVoronoiEngine}};
 
-    sleep(1);
-    srand( time(nullptr) );
-    MappingArray mapping(kmerSpaceSize / 4);
+/*
+ * Runs an engine in a child process, so that every run starts from a fresh 
+ * heap and its peak resident set size can be read with wait4. Returns false
+ * if the child failed.
+ *
+ * engine    : The engine
+ * k         : The length of the k-mer
+ * d         : The maximum edit distance allowed
+ * numThreads: The number of worker threads
+ * result    : The result summary returned by the engine
+ * seconds   : The wall-clock time of the run
+ * peakRSS   : The peak resident set size of the child in kB
+ */
+bool runIsolated( const ScalingEngine &engine, int k, int d, int numThreads,
+                  unsigned long int &result, double &seconds, long &peakRSS )
+{
+    int fds[2];
+    if ( pipe(fds) != 0 )
+    {
+        return false;
+    }
+    // Buffered output would otherwise be written by the child as well
+    cout.flush();
+    cerr.flush();
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if ( pid == 0 )
+    {
+        // Silence the engine, which reports to the console
+        close( fds[0] );
+        int null_fd = open( "/dev/null", O_WRONLY );
+        dup2( null_fd, 2 );
+        unsigned long int value = engine.run( k, d, numThreads );
+        _exit( write(fds[1], &value, 8) == 8 ? 0 : 1 );
+    }
+    close( fds[1] );
+    bool ok = pid > 0 && read( fds[0], &result, 8 ) == 8;
+    close( fds[0] );
+    int status = 0;
+    struct rusage usage;
+    if ( pid > 0 && wait4(pid, &status, 0, &usage) == pid )
+    {
+        peakRSS = usage.ru_maxrss;
+    }
+    else
+    {
+        ok = false;
+    }
+    seconds = chrono::duration<double>(
+                  chrono::steady_clock::now() - t0).count();
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
 
-    cerr << "\nList of independent nodes: " << endl;
-    printKmer( 0, k );
-    cerr << ' ';
-    visit.setVisited(0);
-    bool isCovered = false;
-    for (unsigned long int i = 1; i < kmerSpaceSize; ++i)
+/*
+ * Measures the scaling of every registered engine and prints a CSV table to
+ * the standard output. Strong scaling runs the given k with 1 to maxThreads
+ * threads. Weak scaling runs 1, 4, 16, ... threads and grows k by 1 each 
+ * time the threads are multiplied by 4, which multiplies the k-mers by 4 as
+ * well; each of its points is also run with 1 thread to check the result.
+ * Speedup is relative to 1 thread on the same k for strong scaling and the
+ * scaled speedup (threads times the time at the base k over the time) for 
+ * weak scaling; efficiency is the speedup divided by the threads.
+ *
+ * k         : The length of the k-mer for 1 thread
+ * d         : The maximum edit distance allowed
+ * maxThreads: The largest number of threads
+ */
+void benchmarkScaling( const int k, const int d, const int maxThreads )
+{
+    cout << "engine,scaling,k,d,threads,seconds,speedup,efficiency,result,"
+         << "matches_sequential,peak_rss_kb\n";
+    for (int e = 0; e < NUM_ENGINES; ++e)
     {
-        unsigned long int count = rand() % kmerSpaceSize;
-        unsigned long int kmer;
-        bool found = false;
-        for (kmer = count; kmer < kmerSpaceSize; ++kmer)
+        const ScalingEngine &engine = engines[e];
+        unsigned long int base_result = 0;
+        double base_time = 0;
+        long base_rss = 0;
+        if ( !runIsolated(engine, k, d, 1, base_result, base_time, base_rss) )
         {
-            if (visit[kmer] == 0)
-            {
-                found = true;
-                break;
-            }
+            cerr << engine.name << " failed for k=" << k << ".\n";
+            continue;
         }
-        if ( !found )
+        for (int t = 1; t <= maxThreads; ++t)
         {
-            for (kmer = 1; kmer < count; ++kmer)
+            unsigned long int result = base_result;
+            double seconds = base_time;
+            long rss = base_rss;
+            if ( t > 1 && 
+                 !runIsolated(engine, k, d, t, result, seconds, rss) )
             {
-                if (visit[kmer] == 0)
-                {
-                    break;
-                }
+                cerr << engine.name << " failed with " << t << " threads.\n";
+                continue;
             }
-        }
-        visit.setVisited(kmer);
-
-        if ( askNeighbors(kmer, k, d, mapping) )
-        {
-            continue;
-        }
-
-        int ds[] = {k, k, k, k};
-        unsigned long int temp_v = kmer;
-        for (int j = 0; j < k; ++j)
-        {
-            ds[temp_v & 3]--;
-            temp_v = temp_v >> 2;
+            double speedup = base_time / seconds;
+            cout << engine.name << ",strong," << k << ',' << d << ',' << t 
+                 << ',' << seconds << ',' << speedup << ',' << speedup / t 
+                 << ',' << result << ',' << (result == base_result) << ',' 
+                 << rss << endl;
+            cerr << engine.name << ": " << t << " threads, " << seconds 
+                 << " sec, speedup " << speedup << ".\n";
         }
 
-        for (unsigned long int j = 0; j < MIS.size(); ++j)
+        int weak_k = k;
+        for (int t = 1; t <= maxThreads && weak_k <= 30; t *= 4, ++weak_k)
         {
-            if ( abs(da[j] - ds[0]) > d ||
-                 abs(dc[j] - ds[1]) > d ||
-                 abs(dg[j] - ds[2]) > d ||
-                 abs(dt[j] - ds[3]) > d )
-            {
-                continue;
-            }
-            if ( da[j] + ds[0] <= d ||
-                 dc[j] + ds[1] <= d ||
-                 dg[j] + ds[2] <= d ||
-                 dt[j] + ds[3] <= d ||
-                 editDist(kmer, MIS[j], k, d) <= d)
+            unsigned long int result = base_result;
+            unsigned long int seq_result = base_result;
+            double seconds = base_time;
+            double seq_time = base_time;
+            long rss = base_rss;
+            long seq_rss = base_rss;
+            if ( t > 1 && 
+                 (!runIsolated(engine, weak_k, d, t, result, seconds, rss) ||
+                  !runIsolated(engine, weak_k, d, 1, seq_result, seq_time, 
+                               seq_rss)) )
             {
-                mapping.setMap(kmer, MIS[j]);
-                isCovered = true;
+                cerr << engine.name << " failed for k=" << weak_k << ".\n";
                 break;
             }
+            double speedup = t * base_time / seconds;
+            cout << engine.name << ",weak," << weak_k << ',' << d << ',' << t
+                 << ',' << seconds << ',' << speedup << ',' << speedup / t 
+                 << ',' << result << ',' << (result == seq_result) << ',' 
+                 << rss << endl;
+            cerr << engine.name << ": k=" << weak_k << ", " << t 
+                 << " threads, " << seconds << " sec, efficiency " 
+                 << speedup / t << ".\n";
         }
-
-        if ( isCovered )
-        {
-            isCovered = false;
-            continue;
-        }
-
-        printKmer( kmer, k );
-        cerr << ' ';
-        MIS.push_back( kmer );
-        da.push_back( ds[0] );
-        dc.push_back( ds[1] );
-        dg.push_back( ds[2] );
-        dt.push_back( ds[3] );
-        mapping.setMap( kmer, kmer );
     }
-
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
 }
 
 /*
- * A class for the dist array used in BFS. The array is chopped into subarrays
- * to avoid failures of dynamic allocation.
+ * A static set of k-mers in Eytzinger layout: the sorted keys fill a complete
+ * binary tree stored level by level from index 1, so a search reads one node
+ * per level and the 16 nodes four levels below a node are two consecutive
+ * cache lines that can be prefetched. The tree is padded with a sentinel 
+ * above every k-mer, so every search takes the same number of steps and a 
+ * batch of searches can run in lockstep.
  */
-class DistArray
+class EytzingerSet
 {
 private:
-    char **aptrs;               // An array of pointers to subarrays
-    unsigned long int size;     // The capacity of the whole array in elements
-    unsigned long int num_subs; // Number of subarrays
-    unsigned long int sub_size; // Size of a subarray in bytes
-    unsigned int max_d;         // Maximum edit distance allowed
+    static const unsigned long int SENTINEL = 0x7ffffffffffffffful;
+    static const unsigned long int GROUP = 16; // Searches run in lockstep
+    vector<unsigned long int> tree;            // tree[0] is a sentinel
+    int height;                                // The levels of the tree
 
-public:
     /*
-     * Constructor
+     * Fills a subtree in order with the next keys, or sentinels once the 
+     * keys run out
      *
-     * s: total number of elements
+     * keys: The sorted keys
+     * next: The index of the next key
+     * node: The root of the subtree
      */
-    DistArray( unsigned long int s, unsigned int d )
+    void fill( const vector<unsigned long int> &keys, unsigned long int &next,
+               unsigned long int node )
     {
-        sub_size = 1;
-        sub_size = sub_size << 30;
-        num_subs = s / 4 / sub_size; // Each element occupies 1/4 bytes.
-        if ( (s / 4) % sub_size != 0 )
+        if ( node >= tree.size() )
         {
-            num_subs++;
+            return;
         }
-        aptrs = (char **) calloc( num_subs, sizeof(char *) );
-        for (int i = 0; i < num_subs; ++i)
+        fill( keys, next, 2 * node );
+        tree[node] = next < keys.size() ? keys[next++] : SENTINEL;
+        fill( keys, next, 2 * node + 1 );
+    }
+
+    /*
+     * Returns the node holding the smallest key not below the query, given 
+     * the leaf position a search ended at, or 0 if there is none
+     *
+     * k: The position after the last step of a search
+     */
+    static unsigned long int lowerBound( unsigned long int k )
+    {
+        return k >> __builtin_ffsl( ~k );
+    }
+
+public:
+    /*
+     * Constructor
+     *
+     * keys: The k-mers, in any order
+     */
+    EytzingerSet( vector<unsigned long int> keys )
+    {
+        sort( keys.begin(), keys.end() );
+        keys.erase( unique(keys.begin(), keys.end()), keys.end() );
+        height = 0;
+        while ( (1ul << height) - 1 < keys.size() )
         {
-            aptrs[i] = (char *) calloc( sub_size, 1 );
+            ++height;
         }
-        size = s;
-        max_d = d;
+        tree.assign( 1ul << height, SENTINEL );
+        unsigned long int next = 0;
+        fill( keys, next, 1 );
     }
 
     /*
-     * Destructor
+     * Returns true if a k-mer is in the set
+     *
+     * x: The binary encoding of the k-mer
      */
-    ~DistArray()
+    bool contains( unsigned long int x ) const
     {
-        for (int i = 0; i < num_subs; ++i)
+        unsigned long int k = 1;
+        for (int l = 0; l < height; ++l)
         {
-            free( aptrs[i] );
+            __builtin_prefetch( tree.data() + 16 * k );
+            k = 2 * k + (tree[k] < x);
         }
-        free( aptrs );
+        return tree[lowerBound(k)] == x;
     }
 
     /*
-     * Overload [] operator to return the dist value indexed by sub
+     * Looks up a batch of k-mers, 16 searches at a time in lockstep so that
+     * their memory accesses overlap
      *
-     * sub: The index of the element to be extract
+     * q    : The binary encodings of the k-mers
+     * m    : The number of k-mers
+     * found: Receives 1 for the k-mers in the set and 0 for the others
      */
-    unsigned int operator[]( const unsigned long int &sub )
+    void containsBatch( const unsigned long int *q, unsigned long int m, 
+                        char *found ) const
     {
-        // Find the bit offset
-        int offset = (sub % 4) * 2;
-
-        // Find the byte in which the required element is located
-        unsigned long int bytePos = sub / 4;
-
-        unsigned int dist;
-        memcpy( &dist, &aptrs[bytePos/sub_size][bytePos%sub_size], 1 );
-
-        dist = (dist << (24 + offset)) >> 30;
-        return dist + (max_d + 1)/2 - 1;
+        unsigned long int k[GROUP];
+        for (unsigned long int i = 0; i < m; i += GROUP)
+        {
+            unsigned long int g = min( GROUP, m - i );
+            for (unsigned long int j = 0; j < g; ++j)
+            {
+                k[j] = 1;
+            }
+            for (int l = 0; l < height; ++l)
+            {
+                for (unsigned long int j = 0; j < g; ++j)
+                {
+                    k[j] = 2 * k[j] + (tree[k[j]] < q[i + j]);
+                    __builtin_prefetch( tree.data() + 16 * k[j] );
+                }
+            }
+            for (unsigned long int j = 0; j < g; ++j)
+            {
+                found[i + j] = tree[lowerBound(k[j])] == q[i + j];
+            }
+        }
     }
-    
+
     /*
-     * Set the dist value for an element indexed by sub
+     * Looks up a batch of k-mers like containsBatch, advancing 4 searches per
+     * AVX2 gather and compare
      *
-     * sub : The index of the element
-     * dist: The dist value of the element
+     * q    : The binary encodings of the k-mers
+     * m    : The number of k-mers
+     * found: Receives 1 for the k-mers in the set and 0 for the others
      */
-    void setDist( const unsigned long int sub, int dist )
+    __attribute__((target("avx2")))
+    void containsAVX2( const unsigned long int *q, unsigned long int m, 
+                       char *found ) const
     {
-        dist = dist + 1 - (max_d + 1)/2;
-        if (dist < 2)
+        const long long *t = (const long long *) tree.data();
+        unsigned long int k[GROUP];
+        unsigned long int i = 0;
+        for ( ; i + GROUP <= m; i += GROUP)
         {
-            dist = 1;
+            __m256i x[GROUP / 4], v[GROUP / 4];
+            for (unsigned long int j = 0; j < GROUP / 4; ++j)
+            {
+                x[j] = _mm256_loadu_si256( (const __m256i *) (q + i + 4 * j) );
+                v[j] = _mm256_set1_epi64x( 1 );
+            }
+            for (int l = 0; l < height; ++l)
+            {
+                for (unsigned long int j = 0; j < GROUP / 4; ++j)
+                {
+                    // The compare yields -1 where the node is below the key
+                    __m256i node = _mm256_i64gather_epi64( t, v[j], 8 );
+                    v[j] = _mm256_sub_epi64( _mm256_add_epi64(v[j], v[j]), 
+                                             _mm256_cmpgt_epi64(x[j], node) );
+                }
+            }
+            for (unsigned long int j = 0; j < GROUP / 4; ++j)
+            {
+                _mm256_storeu_si256( (__m256i *) (k + 4 * j), v[j] );
+            }
+            for (unsigned long int j = 0; j < GROUP; ++j)
+            {
+                found[i + j] = tree[lowerBound(k[j])] == q[i + j];
+            }
         }
+        containsBatch( q + i, m - i, found + i );
+    }
 
-        // Find the byte in which the required element is located
-        unsigned long int bytePos = sub / 4;
-
-        // Find the bit offset
-        int offset = (sub % 4) * 2;
-
-        unsigned int tempByte;
-        memcpy( &tempByte, &aptrs[bytePos/sub_size][bytePos%sub_size], 1 );
-        unsigned int head = tempByte >> (8 - offset);
-        head = head << (8 - offset);
-        unsigned int tail = tempByte << 24 << (offset + 2);
-        tail = tail >> 24 >> (offset + 2);
-        tempByte = tempByte & (head | tail);
-        unsigned int body = dist;
-        body = body << (6 - offset);
-        tempByte = tempByte | body;
-        memcpy( &aptrs[bytePos/sub_size][bytePos%sub_size], &tempByte, 1 );
+    /*
+     * Returns the memory used by the tree in bytes
+     */
+    unsigned long int bytes() const
+    {
+        return tree.size() * 8;
     }
 };
 
+const unsigned long int EytzingerSet::SENTINEL;
+const unsigned long int EytzingerSet::GROUP;
+
 /*
- * Gets neighbors of a vertex
- *
- * enc: The binary encoding of the k-mer
- * k  : The length of the k-mer
- * n  : A unordered_set to hold the neighbors
+ * A static quotient filter (Bender et al.) over the hashes of a set of 
+ * k-mers, a compact front for an exact set: a miss is certain, and a hit is
+ * false with a probability of about 2^-16. The top q bits of a hash choose a
+ * home slot and the next 16 bits are stored as its remainder. The remainders
+ * of one home slot form a sorted run, runs of consecutive home slots form a
+ * cluster, and three flags per slot (occupied, continuation, shifted) lead a
+ * lookup from the home slot to its run. The hashes are inserted in sorted 
+ * order, so runs are only appended, and the table ends in an overflow area 
+ * instead of wrapping around.
  */
-void getNeighbor( unsigned long int enc, int k, 
-                  unordered_set<unsigned long int> &n )
+class QuotientFilter
 {
-    unsigned long int i = enc >> 2;
+private:
+    static const unsigned char OCCUPIED = 1;     // A run has this home slot
+    static const unsigned char CONTINUATION = 2; // Not the first of its run
+    static const unsigned char SHIFTED = 4;      // Not in its home slot
+    static const int REMAINDER_BITS = 16;
 
-    // Populate the adjacency list for kmers
-    if ( (enc & 3) == 1 )
+    int qbits;                          // The bits of the home slot
+    vector<unsigned short> remainders;  // The remainder held by each slot
+    vector<unsigned char> flags;        // The flags of each slot
+
+    /*
+     * Returns the fingerprint of a k-mer: the top bits of its hash, home 
+     * slot first
+     *
+     * x: The binary encoding of the k-mer
+     */
+    unsigned long int fingerprint( unsigned long int x ) const
     {
-        // Handle deletion
-        for (int j = 1; j <= k; ++j)
+        // The finalizer of splitmix64
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ul;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebul;
+        x = x ^ (x >> 31);
+        return x >> (64 - qbits - REMAINDER_BITS);
+    }
+
+public:
+    /*
+     * Constructor, sizing the table for a load of at most 3/4
+     *
+     * keys: The k-mers
+     */
+    QuotientFilter( const vector<unsigned long int> &keys )
+    {
+        qbits = 1;
+        while ( (3ul << qbits) < 4 * keys.size() )
         {
-            unsigned long int head = (i >> (2 * j)) << (2 * (j - 1));
-            unsigned long int tail = (i << 1 << (63 - 2 * (j - 1))) >> 
-                                     (63 - 2 * (j - 1)) >> 1;
-            n.emplace( (head + tail) << 2 );
+            ++qbits;
+        }
+        vector<unsigned long int> prints;
+        for ( const unsigned long int &x : keys )
+        {
+            prints.push_back( fingerprint(x) );
         }
+        sort( prints.begin(), prints.end() );
+        prints.erase( unique(prints.begin(), prints.end()), prints.end() );
 
-        // Handle substitution
-        for (int j = 1; j <= k; ++j)
+        remainders.assign( 1ul << qbits, 0 );
+        flags.assign( 1ul << qbits, 0 );
+        unsigned long int next = 0;  // The first free slot
+        unsigned long int last = ~0ul; // The home slot of the last insert
+        for ( const unsigned long int &f : prints )
         {
-            unsigned long int head = (i >> (2 * j)) << (2 * j);
-            unsigned long int tail = (i << 1 << (63 - 2 * (j - 1))) >> 
-                                     (63 - 2 * (j - 1)) >> 1;
-            for (unsigned long int l = 0; l < 4; ++l)
+            unsigned long int home = f >> REMAINDER_BITS;
+            unsigned long int slot = max( home, next );
+            if ( slot >= flags.size() )
             {
-                unsigned long int body = l << (2 * (j - 1));
-                unsigned long int node = head + body + tail;
-                if ( node != i )
-                {
-                    n.emplace( (node << 2) | 1 );
-                }
+                remainders.push_back( 0 );
+                flags.push_back( 0 );
+            }
+            flags[home] |= OCCUPIED;
+            if ( home == last )
+            {
+                flags[slot] |= CONTINUATION;
+            }
+            if ( slot != home )
+            {
+                flags[slot] |= SHIFTED;
             }
+            remainders[slot] = f & ((1ul << REMAINDER_BITS) - 1);
+            next = slot + 1;
+            last = home;
+        }
+
+        // An empty slot ends the last cluster
+        remainders.push_back( 0 );
+        flags.push_back( 0 );
+    }
+
+    /*
+     * Returns false if a k-mer is certainly not in the set
+     *
+     * x: The binary encoding of the k-mer
+     */
+    bool mayContain( unsigned long int x ) const
+    {
+        unsigned long int f = fingerprint( x );
+        unsigned long int home = f >> REMAINDER_BITS;
+        unsigned short rem = f & ((1ul << REMAINDER_BITS) - 1);
+        if ( !(flags[home] & OCCUPIED) )
+        {
+            return false;
+        }
+
+        // Walk back to the start of the cluster, then forward one run per
+        // occupied home slot up to the home slot of x
+        unsigned long int b = home;
+        while ( flags[b] & SHIFTED )
+        {
+            --b;
+        }
+        unsigned long int s = b;
+        while ( b != home )
+        {
+            do
+            {
+                ++s;
+            } while ( flags[s] & CONTINUATION );
+            do
+            {
+                ++b;
+            } while ( !(flags[b] & OCCUPIED) );
         }
-    }
 
-    // Populate the adjacency list for kMinus1mers
-    else
-    {
-        // Handle insertion
-        for (int j = 0; j <= k - 1; ++j)
+        // The run is sorted
+        do
         {
-            unsigned long int head = (i >> (2 * j)) << (2 * (j + 1));
-            unsigned long int tail = (i << 1 << (63 - 2 * j)) >> 
-                                     (63 - 2 * j) >> 1;
-            for (unsigned long int l = 0; l < 4; ++l)
+            if ( remainders[s] >= rem )
             {
-                unsigned long int body = l << (2 * j);
-                unsigned long int node = head + body + tail;
-                n.emplace( (node << 2) | 1 );
+                return remainders[s] == rem;
             }
-        }
+            ++s;
+        } while ( flags[s] & CONTINUATION );
+        return false;
     }
-}
+
+    /*
+     * Returns the memory used by the filter in bytes
+     */
+    unsigned long int bytes() const
+    {
+        return remainders.size() * 3;
+    }
+};
 
 /*
- * Implementation of the BFS method with alphabetical order of k-mer iteration
+ * Benchmarks membership tests against a random subset of the k-mers, as an
+ * induced-subgraph run needs for every k-mer found in a ball. The queries are
+ * the balls of the first members of the subset. Prints the time per lookup 
+ * and the memory of std::unordered_set, as used in the rest of the code, of
+ * binary search in the sorted subset, of an EytzingerSet searched one k-mer
+ * at a time, in batches and with AVX2 gathers, and of a QuotientFilter in 
+ * front of the batched EytzingerSet.
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * n   : The size of the subset
+ * seed: The seed of the subset
  */
-void doBFS( const int k, const int d )
+void benchmarkMembership( const int k, const int d, unsigned long int n, 
+                          unsigned int seed )
 {
-    // Initialize dist arrays for BFS
+    const unsigned long int max_queries = 1ul << 21;
     unsigned long int num_kmers = 1ul << (2 * k);
-    DistArray dist_kmer(num_kmers, d);
+    n = min( n, num_kmers );
 
-    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
-    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+    // The first positions of a random permutation are distinct k-mers
+    BlockOrder shuffle(num_kmers, num_kmers, seed);
+    vector<unsigned long int> present(n);
+    for (unsigned long int i = 0; i < n; ++i)
+    {
+        present[i] = shuffle[i];
+    }
+    vector<unsigned long int> queries;
+    vector<unsigned long int> ball;
+    for (unsigned long int i = 0; i < n && queries.size() < max_queries; ++i)
+    {
+        getBall( present[i], k, d, ball );
+        queries.insert( queries.end(), ball.begin(), ball.end() );
+    }
+    unsigned long int m = queries.size();
+    if ( m == 0 )
+    {
+        cerr << "The subset has no neighbors to look up.\n";
+        return;
+    }
+    vector<char> found(m);
 
-    unsigned long int num_indep_nodes = 0;
-    cerr << "\nList of independent nodes: " << endl;
-    for ( unsigned long int i = 0; i < num_kmers; ++i )
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unordered_set<unsigned long int> hashed(present.begin(), present.end());
+    double hashed_build = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    EytzingerSet eytzinger(present);
+    double eytzinger_build = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    QuotientFilter filter(present);
+    double filter_build = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    vector<unsigned long int> sorted = present;
+    sort( sorted.begin(), sorted.end() );
+
+    const int NUM_METHODS = 6;
+    const char *names[NUM_METHODS] = {
+        "unordered_set:         ", "Binary search:         ", 
+        "Eytzinger:             ", "Eytzinger, batched:    ",
+        "Eytzinger, AVX2:       ", "Quotient filter front: "};
+    double seconds[NUM_METHODS];
+    unsigned long int hits[NUM_METHODS];
+    unsigned long int passed = 0; // Queries let through by the filter
+    for (int method = 0; method < NUM_METHODS; ++method)
     {
-        if ( dist_kmer[i] != (d + 1)/2 - 1 )
+        if ( method == 4 && !__builtin_cpu_supports("avx2") )
         {
             continue;
         }
-        printKmer(i, k);
-        cerr << ' ';
-        num_indep_nodes++;
-
-        // Do BFS
-        vector<unsigned long int> Q; // Initialize an empty queue
-        Q.push_back( (i << 2) | 1 );
-
-        // Keep the search history
-        unordered_map<unsigned long int, unsigned int> hist;
-        hist.emplace( (i << 2) | 1, 0 );
-
-        dist_kmer.setDist(i, 0);
-        while ( !Q.empty() )
+        start = chrono::steady_clock::now();
+        if ( method == 0 )
         {
-            auto q0 = hist.find( Q[0] );
-            if ( q0->second + 1 > d )
+            for (unsigned long int i = 0; i < m; ++i)
             {
-                break;
+                found[i] = hashed.count( queries[i] );
             }
-            unordered_set<unsigned long int> neighbors;
-            getNeighbor( Q[0], k, neighbors );
-
-            if ( (Q[0] & 3) == 1 )
+        }
+        else if ( method == 1 )
+        {
+            for (unsigned long int i = 0; i < m; ++i)
             {
-                for ( auto &j : neighbors )
-                {
-                    if ( hist.find(j) != hist.end() )
-                    {
-                        continue;
-                    }
-                    unsigned int targetDist;
-                    if ( (j & 3) == 1 )
-                    {
-                        targetDist = dist_kmer[j >> 2];
-                        if ( targetDist == (d + 1)/2 - 1 ||
-                             (targetDist != (d + 1)/2 &&
-                              targetDist > q0->second + 1) )
-                        {
-                            dist_kmer.setDist(j >> 2, q0->second + 1);
-                            Q.push_back(j);
-                            hist.emplace( j, q0->second + 1 );
-                        }
-                    }
-                    else
-                    {
-                        targetDist = dist_kMinus1mer[j >> 2];
-                        if ( targetDist == (d + 1)/2 - 1 ||
-                             (targetDist != (d + 1)/2 &&
-                              targetDist > q0->second + 1) )
-                        {
-                            dist_kMinus1mer.setDist(j >> 2, q0->second + 1);
-                            Q.push_back(j);
-                            hist.emplace( j, q0->second + 1 );
-                        }
-                    }
-                }
+                found[i] = binary_search( sorted.begin(), sorted.end(), 
+                                          queries[i] );
             }
-            else
+        }
+        else if ( method == 2 )
+        {
+            for (unsigned long int i = 0; i < m; ++i)
+            {
+                found[i] = eytzinger.contains( queries[i] );
+            }
+        }
+        else if ( method == 3 )
+        {
+            eytzinger.containsBatch( queries.data(), m, found.data() );
+        }
+        else if ( method == 4 )
+        {
+            eytzinger.containsAVX2( queries.data(), m, found.data() );
+        }
+        else
+        {
+            // Only the queries the filter lets through reach the tree
+            vector<unsigned long int> maybe;
+            vector<unsigned long int> where;
+            for (unsigned long int i = 0; i < m; ++i)
             {
-                for ( auto &j : neighbors )
+                found[i] = 0;
+                if ( filter.mayContain(queries[i]) )
                 {
-                    if ( hist.find(j) != hist.end() )
-                    {
-                        continue;
-                    }
-                    unsigned int targetDist = dist_kmer[j >> 2];
-                    if ( targetDist == (d + 1)/2 - 1 || 
-                         (targetDist != (d + 1)/2 &&
-                          targetDist > q0->second + 1) )
-                    {
-                        dist_kmer.setDist(j >> 2, q0->second + 1);
-                        Q.push_back(j);
-                        hist.emplace( j, q0->second + 1 );
-                    }
+                    maybe.push_back( queries[i] );
+                    where.push_back( i );
                 }
             }
-            Q.erase( Q.begin() );
+            vector<char> exact(maybe.size());
+            eytzinger.containsBatch( maybe.data(), maybe.size(), 
+                                     exact.data() );
+            for (unsigned long int j = 0; j < maybe.size(); ++j)
+            {
+                found[where[j]] = exact[j];
+            }
+            passed = maybe.size();
         }
+        seconds[method] = chrono::duration<double>(
+            chrono::steady_clock::now() - start).count();
+        hits[method] = count( found.begin(), found.end(), 1 );
     }
 
-    cerr << "\nThe graph has an independent set of size " << num_indep_nodes 
-         << ".\n\n";
+    // A node of unordered_set holds the key and a pointer, plus a bucket
+    unsigned long int bytes[NUM_METHODS] = {
+        hashed.size() * 32 + hashed.bucket_count() * 8, sorted.size() * 8,
+        eytzinger.bytes(), eytzinger.bytes(), eytzinger.bytes(), 
+        eytzinger.bytes() + filter.bytes()};
+    cerr << "Membership tests of " << m << " k-mers in the balls of radius "
+         << d << " around a subset of " << n << " k-mers (k=" << k 
+         << "), " << hits[0] << " of them in the subset:\n";
+    for (int method = 0; method < NUM_METHODS; ++method)
+    {
+        if ( method == 4 && !__builtin_cpu_supports("avx2") )
+        {
+            cerr << names[method] << "unsupported\n";
+            continue;
+        }
+        cerr << names[method] << seconds[method] * 1e9 / m 
+             << " ns per lookup, " << (double) bytes[method] / n 
+             << " bytes per k-mer" 
+             << (hits[method] == hits[0] ? "" : ", WRONG ANSWERS") << "\n";
+    }
+    cerr << "The filter lets " << passed << " queries through, "
+         << passed - hits[0] << " of them false positives ("
+         << (passed - hits[0]) * 100.0 / (m - hits[0]) << "% of misses).\n"
+         << "Built in " << hashed_build << " sec (unordered_set), " 
+         << eytzinger_build << " sec (Eytzinger) and " << filter_build 
+         << " sec (filter).\n\n";
     reportPerformance();
 }
 
 /*
- * Implementation of the BFS method with random order of k-mer iteration
+ * Finishes writing the independent nodes to the output file, if one was given
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * filename: The output file
  */
-void doRandBFS( const int k, const int d )
+void closeMemberOutput( const string &filename )
 {
-    // Initialize dist arrays for BFS
-    unsigned long int num_kmers = 1ul << (2 * k);
-    DistArray dist_kmer(num_kmers, d);
+    if ( memberOutput == nullptr )
+    {
+        return;
+    }
+    if ( memberOutput->finish() )
+    {
+        cerr << "The independent nodes were written to " << filename 
+             << " using " << memberOutput->backend() << ".\n";
+    }
+    else
+    {
+        cerr << "Failed to write the independent nodes to " << filename 
+             << ".\n";
+    }
+    delete memberOutput;
+    memberOutput = nullptr;
+}
 
-    unsigned long int num_kMinus1mers = 1ul << (2 * (k-1));
-    DistArray dist_kMinus1mer(num_kMinus1mers, d);
+int main( int argc, char *argv[] )
+{
+    cerr << "This program is used to find a MIS in a k-mer space. Valid inputs"
+         << " for the integer parameters k and d should satisfy 2<=k<=30 and"
+         << " 1<=d<k.\n";
 
-    unsigned long int num_indep_nodes = 0;
-    sleep(1);
-    srand( time(nullptr) );
-    cerr << "\nList of independent nodes: " << endl;
-    for ( unsigned long int i = 0; i < num_kmers; ++i )
+    // Parse the optional arguments
+    RunOptions opts;
+    string resumeFile;
+    string cacheDir;
+    bool seedGiven = false;
+    string outputFile;
+    string graphFile;
+    string heatmapFile;
+    int heatmapPrefix = 2;
+    unsigned long int membershipSize = 0;
+    int benchThreads = 0;
+    int numThreads = thread::hardware_concurrency();
+    if ( numThreads < 1 )
     {
-        unsigned long int count = rand() % num_kmers;
-        unsigned long int kmer;
-        bool found = false;
-        for (kmer = count; kmer < num_kmers; ++kmer)
+        numThreads = 1;
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        if ( strcmp(argv[i], "--export-graph") == 0 && i + 1 < argc )
         {
-            if (dist_kmer[kmer] == (d + 1)/2 - 1)
-            {
-                found = true;
-                break;
-            }
+            graphFile = argv[++i];
         }
-        if ( !found )
+        else if ( strcmp(argv[i], "--threads") == 0 && i + 1 < argc &&
+                  atoi(argv[i + 1]) >= 1 )
         {
-            for (kmer = 0; kmer < count; ++kmer)
-            {
-                if (dist_kmer[kmer] == (d + 1)/2 - 1)
-                {
-                    found = true;
-                    break;
-                }
-            }
+            numThreads = atoi( argv[++i] );
         }
-        if ( !found )
+        else if ( strcmp(argv[i], "--bench-scaling") == 0 && i + 1 < argc )
         {
-            break;
+            benchThreads = atoi( argv[++i] );
+        }
+        else if ( strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc )
+        {
+            opts.timeLimit = atof( argv[++i] );
+        }
+        else if ( strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc )
+        {
+            opts.checkpointFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--resume") == 0 && i + 1 < argc )
+        {
+            resumeFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--cache") == 0 && i + 1 < argc )
+        {
+            cacheDir = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--seed") == 0 && i + 1 < argc )
+        {
+            opts.seed = strtoul( argv[++i], nullptr, 10 );
+            seedGiven = true;
+        }
+        else if ( strcmp(argv[i], "--block-size") == 0 && i + 1 < argc )
+        {
+            opts.blockSize = strtoul( argv[++i], nullptr, 10 );
+        }
+        else if ( strcmp(argv[i], "--output") == 0 && i + 1 < argc )
+        {
+            outputFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--witness") == 0 && i + 1 < argc )
+        {
+            opts.witnessFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--voronoi") == 0 && i + 1 < argc )
+        {
+            opts.voronoiFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--pipeline") == 0 )
+        {
+            opts.pipeline = true;
+        }
+        else if ( strcmp(argv[i], "--bench-membership") == 0 && 
+                  i + 1 < argc )
+        {
+            membershipSize = strtoul( argv[++i], nullptr, 10 );
+        }
+        else if ( strcmp(argv[i], "--heatmap") == 0 && i + 1 < argc )
+        {
+            heatmapFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--heatmap-prefix") == 0 && i + 1 < argc )
+        {
+            heatmapPrefix = atoi( argv[++i] );
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--export-graph FILE] "
+                 << "[--threads N] [--bench-scaling N] [--time-limit SECONDS] "
+                 << "[--checkpoint FILE] [--resume FILE] [--cache DIR] "
+                 << "[--seed N] [--block-size N] [--output FILE] "
+                 << "[--witness FILE] [--voronoi FILE] [--pipeline] "
+                 << "[--heatmap FILE] [--heatmap-prefix P] "
+                 << "[--bench-membership N]\n";
+            return 1;
         }
+    }
 
-        printKmer(kmer, k);
-        cerr << ' ';
-        num_indep_nodes++;
+    opts.numThreads = numThreads;
 
-        // Do BFS
-        vector<unsigned long int> Q; // Initialize an empty queue
-        Q.push_back( (kmer << 2) | 1 );
+    int k;
+    int d;
+    int method;
+    int random;
 
-        // Keep the search history
-        unordered_map<unsigned long int, unsigned int> hist;
-        hist.emplace( (kmer << 2) | 1, 0 );
+    // A resumed run takes its parameters from the checkpoint
+    if ( !resumeFile.empty() )
+    {
+        MISFileHeader header;
+        if ( !readMISFile(resumeFile, header, opts.resumeMIS) || 
+             header.metric != METRIC )
+        {
+            cerr << "Cannot resume from " << resumeFile << ".\n";
+            return 1;
+        }
+        k = header.k;
+        d = header.d;
+        method = header.method;
+        random = header.order;
+        opts.resumeCursor = header.cursor;
+        opts.seed = header.seed;
+        cerr << "Resuming k=" << k << ", d=" << d << ", approach " << method
+             << ", order " << random << " at iteration " << header.cursor 
+             << " with " << opts.resumeMIS.size() << " independent nodes.\n";
+    }
+    else
+    {
+        cerr << "Please enter k: ";
+        cin >> k;
+        cerr << k << endl;
+        cerr << "Plesae enter d: ";
+        cin >> d;
+        cerr << d << endl;
 
-        dist_kmer.setDist(kmer, 0);
-        while ( !Q.empty() )
+        if ( !graphFile.empty() )
         {
-            auto q0 = hist.find( Q[0] );
-            if ( q0->second + 1 > d )
-            {
-                break;
-            }
-            unordered_set<unsigned long int> neighbors;
-            getNeighbor( Q[0], k, neighbors );
+            exportGraph( k, d, graphFile, numThreads );
+            return 0;
+        }
+        if ( benchThreads > 0 )
+        {
+            benchmarkScaling( k, d, benchThreads );
+            return 0;
+        }
+        if ( membershipSize > 0 )
+        {
+            benchmarkMembership( k, d, membershipSize, opts.seed );
+            return 0;
+        }
 
-            if ( (Q[0] & 3) == 1 )
-            {
-                for ( auto &j : neighbors )
-                {
-                    if ( hist.find(j) != hist.end() )
-                    {
-                        continue;
-                    }
-                    unsigned int targetDist;
-                    if ( (j & 3) == 1 )
-                    {
-                        targetDist = dist_kmer[j >> 2];
-                        if ( targetDist == (d + 1)/2 - 1 ||
-                             (targetDist != (d + 1)/2 &&
-                              targetDist > q0->second + 1) )
-                        {
-                            dist_kmer.setDist(j >> 2, q0->second + 1);
-                            Q.push_back(j);
-                            hist.emplace( j, q0->second + 1 );
-                        }
-                    }
-                    else
-                    {
-                        targetDist = dist_kMinus1mer[j >> 2];
-                        if ( targetDist == (d + 1)/2 - 1 ||
-                             (targetDist != (d + 1)/2 &&
-                              targetDist > q0->second + 1) )
-                        {
-                            dist_kMinus1mer.setDist(j >> 2, q0->second + 1);
-                            Q.push_back(j);
-                            hist.emplace( j, q0->second + 1 );
-                        }
-                    }
-                }
-            }
-            else
-            {
-                for ( auto &j : neighbors )
-                {
-                    if ( hist.find(j) != hist.end() )
-                    {
-                        continue;
-                    }
-                    unsigned int targetDist = dist_kmer[j >> 2];
-                    if ( targetDist == (d + 1)/2 - 1 || 
-                         (targetDist != (d + 1)/2 &&
-                          targetDist > q0->second + 1) )
-                    {
-                        dist_kmer.setDist(j >> 2, q0->second + 1);
-                        Q.push_back(j);
-                        hist.emplace( j, q0->second + 1 );
-                    }
-                }
-            }
-            Q.erase( Q.begin() );
+        cerr << "Please choose an approach. Notice that the BFS approaches do "
+             << "not support d>5. Enter 1 for Simple Greedy, 2 for Improved "
+             << "Greedy, 3 for BFS, 4 for Tiled Simple Greedy, 5 for BFS "
+             << "seeded with a Varshamov-Tenengolts code, or 6 for BFS with a "
+             << "hierarchy of representatives (4 to 6 in alphabetical order "
+             << "only): ";
+        cin >> method;
+        cerr << method << endl;
+        cerr << "The iteration order of k-mers affects the resulting MIS size "
+             << "and the performance of the program.\n"
+             << "Please choose the iteration order of k-mers. Enter 1 for "
+             << "random order, 2 for alphabetical order, or 3 for "
+             << "block-randomized order (approaches 2 and 3 only): ";
+        cin >> random;
+        cerr << random << endl;
+    }
+
+    if ( !outputFile.empty() )
+    {
+        memberOutput = new AsyncWriter(outputFile);
+        if ( !memberOutput->good() )
+        {
+            cerr << "Cannot open " << outputFile << ".\n";
+            return 1;
         }
     }
 
-    cerr << "\nThe graph has an independent set of size " << num_indep_nodes 
-         << ".\n\n";
-    reportPerformance();
-}
+    // A clock seed never recurs, so its entry could never be hit again
+    if ( !cacheDir.empty() && random != 2 && !seedGiven && 
+         resumeFile.empty() )
+    {
+        cerr << "Runs in random or block-randomized order without --seed "
+             << "are not cached.\n";
+        cacheDir.clear();
+    }
 
-int main()
-{
-    cerr << "This program is used to find a MIS in a k-mer space. Valid inputs"
-         << " for the integer parameters k and d should satisfy 2<=k<=30 and"
-         << " 1<=d<k.\n";
+    // A cached result is reused, a cached snapshot continued
+    if ( !cacheDir.empty() && resumeFile.empty() && 
+         lookupCache(cacheDir, k, d, method, random, opts) )
+    {
+        closeMemberOutput( outputFile );
+        return 0;
+    }
 
-    int k;
-    int d;
-    int method;
-    int random;
-    cerr << "Please enter k: ";
-    cin >> k;
-    cerr << k << endl;
-    cerr << "Plesae enter d: ";
-    cin >> d;
-    cerr << d << endl;
-    cerr << "Please choose an approach. Notice that the BFS approach does not " 
-         << "support d>5. Enter 1 for Simple Greedy, 2 for Improved Greedy, "
-         << "or 3 for BFS: ";
-    cin >> method;
-    cerr << method << endl;
-    cerr << "The iteration order of k-mers affects the resulting MIS size and "
-         << "the performance of the program.\n"
-         << "Please choose the iteration order of k-mers. Enter 1 for random "
-         << "order or 2 for alphabetical order: ";
-    cin >> random;
-    cerr << random << endl;
+    // The greedy methods spend their time in edit distance calls
+    if ( method == 1 || method == 2 || method == 4 || method == 6 )
+    {
+        autotune( k, d, "kmerspace.profile" );
+    }
+
+    // The counters are not atomic, so the pipeline is not instrumented
+    if ( !heatmapFile.empty() && opts.pipeline )
+    {
+        cerr << "The pipeline is not instrumented, so no heatmap is written "
+             << "to " << heatmapFile << ".\n";
+    }
+    else if ( !heatmapFile.empty() )
+    {
+        heatmap = new RegionHeatmap(k, heatmapPrefix);
+    }
 
     if ( random == 2 )
     {
-        if ( method == 1 )
+        if ( method == 1 && opts.pipeline )
+        {
+            doPipelinedPairwiseCmp( k, d, opts );
+        }
+        else if ( method == 1 )
         {
-            doPairwiseCmp( k, d );
+            doPairwiseCmp( k, d, opts );
         }
         else if ( method == 2 )
         {
-            doHeuristic( k, d );
+            doHeuristic( k, d, opts );
         }
         else if ( method == 3 )
         {
-            doBFS( k, d );
+            doBFS( k, d, opts );
+        }
+        else if ( method == 4 )
+        {
+            doTiledPairwiseCmp( k, d, opts );
+        }
+        else if ( method == 5 )
+        {
+            doVTSeededBFS( k, d, opts );
+        }
+        else if ( method == 6 )
+        {
+            doHierarchy( k, d, opts );
         }
     }
     else if ( random == 1 )
     {
         if ( method == 1 )
         {
-            doRandPairwiseCmp( k, d );
+            doRandPairwiseCmp( k, d, opts );
         }
         else if ( method == 2 )
         {
-            doRandHeuristic( k, d );
+            doRandHeuristic( k, d, opts );
+        }
+        else if ( method == 3 )
+        {
+            doRandBFS( k, d, opts );
+        }
+    }
+    else if ( random == 3 )
+    {
+        if ( method == 2 )
+        {
+            doHeuristic( k, d, opts, 3 );
         }
         else if ( method == 3 )
         {
-            doRandBFS( k, d );
+            doBFS( k, d, opts, 3 );
+        }
+    }
+    if ( heatmap != nullptr )
+    {
+        if ( !heatmap->write(heatmapFile) )
+        {
+            cerr << "Failed to save the region heatmap to " << heatmapFile 
+                 << ".\n";
         }
+        delete heatmap;
+        heatmap = nullptr;
     }
+    closeMemberOutput( outputFile );
     return 0;
 }
@@ -16,13 +16,27 @@
 #include <deque>
 #include <iterator>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
+#include <linux/io_uring.h>
 #include <ios>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "misfile.h"
 
 using namespace std;
 
+// The distance recorded in the binary MIS files written by this program
+const char METRIC = 'H';
+
 /*
  * Prints a k-mer given its binary encoding according to the following 
  * binary-to-base translation: 00 -> A, 01 -> C, 10 -> G, 11 -> T
@@ -43,6 +57,410 @@ void printKmer( unsigned long int enc, int k )
     cerr << kmer;
 }
 
+/*
+ * Writes a stream of bytes to a file in the background, so that the scans do
+ * not wait for the disk. Data is collected in page-aligned buffers; a full
+ * buffer is submitted through io_uring, or handed to a writer thread calling 
+ * pwrite where io_uring is not available, while the next one is filled. The
+ * file is opened with O_DIRECT where the file system supports it.
+ */
+class AsyncWriter
+{
+private:
+    static const unsigned int NUM_BUFFERS = 4;     // Buffers in rotation
+    static const unsigned long int BUFFER_SIZE = 1ul << 20; // Bytes each
+    static const unsigned long int ALIGNMENT = 4096; // For O_DIRECT
+
+    int fd;                           // The output file
+    bool direct;                      // True if opened with O_DIRECT
+    bool failed;                      // True if a write failed
+    char *buffers[NUM_BUFFERS];       // The aligned buffers
+    bool busy[NUM_BUFFERS];           // True while a buffer is being written
+    unsigned int cur;                 // The buffer being filled
+    unsigned long int used;           // Bytes used in the current buffer
+    unsigned long int offset;         // File offset of the current buffer
+
+    int ring;                         // The io_uring, -1 if not used
+    void *sqPtr, *cqPtr;              // The mapped rings
+    unsigned long int sqSize, cqSize; // The sizes of the mapped rings
+    unsigned int *sqTail, *sqMask, *sqArray; // The submission ring
+    unsigned int *cqHead, *cqTail, *cqMask;  // The completion ring
+    struct io_uring_sqe *sqes;        // The submission entries
+    struct io_uring_cqe *cqes;        // The completion entries
+    unsigned int numEntries;          // The number of submission entries
+
+    thread writer;                    // The writer thread of the fallback
+    mutex lock;                       // Guards busy and jobs
+    condition_variable changed;       // Signals new jobs and completions
+    deque<pair<unsigned int, unsigned long int>> jobs; // Buffer, length
+    deque<unsigned long int> jobOffsets;             // File offset per job
+    bool closing;                     // Tells the writer thread to finish
+
+    /*
+     * Returns true if the io_uring supports IORING_OP_WRITE. Kernels before
+     * 5.6 have neither the probe nor the opcode.
+     */
+    bool probeWrite()
+    {
+        unsigned long int len = sizeof(struct io_uring_probe) + 
+                                IORING_OP_LAST * 
+                                sizeof(struct io_uring_probe_op);
+        struct io_uring_probe *probe = (struct io_uring_probe *) 
+                                       calloc( 1, len );
+        bool supported = 
+            syscall( __NR_io_uring_register, ring, IORING_REGISTER_PROBE, 
+                     probe, IORING_OP_LAST ) >= 0 &&
+            probe->last_op >= IORING_OP_WRITE &&
+            (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+        free( probe );
+        return supported;
+    }
+
+    /*
+     * Sets up an io_uring with one entry per buffer. Returns false if the 
+     * kernel does not support it or its writes.
+     */
+    bool setupRing()
+    {
+        struct io_uring_params params;
+        memset( &params, 0, sizeof(params) );
+        ring = syscall( __NR_io_uring_setup, NUM_BUFFERS, &params );
+        if ( ring < 0 )
+        {
+            return false;
+        }
+        if ( !probeWrite() )
+        {
+            close( ring );
+            ring = -1;
+            return false;
+        }
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + 
+                 params.cq_entries * sizeof(struct io_uring_cqe);
+        if ( params.features & IORING_FEAT_SINGLE_MMAP )
+        {
+            sqSize = cqSize = max( sqSize, cqSize );
+        }
+        sqPtr = mmap( nullptr, sqSize, PROT_READ | PROT_WRITE, 
+                      MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING );
+        cqPtr = sqPtr;
+        if ( sqPtr != MAP_FAILED && 
+             !(params.features & IORING_FEAT_SINGLE_MMAP) )
+        {
+            cqPtr = mmap( nullptr, cqSize, PROT_READ | PROT_WRITE, 
+                          MAP_SHARED | MAP_POPULATE, ring, 
+                          IORING_OFF_CQ_RING );
+        }
+        numEntries = params.sq_entries;
+        sqes = (struct io_uring_sqe *) mmap( nullptr, 
+                   numEntries * sizeof(struct io_uring_sqe), 
+                   PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, 
+                   IORING_OFF_SQES );
+        if ( sqPtr == MAP_FAILED || cqPtr == MAP_FAILED || 
+             sqes == MAP_FAILED )
+        {
+            close( ring );
+            ring = -1;
+            return false;
+        }
+
+        char *sq = (char *) sqPtr;
+        char *cq = (char *) cqPtr;
+        sqTail = (unsigned int *) (sq + params.sq_off.tail);
+        sqMask = (unsigned int *) (sq + params.sq_off.ring_mask);
+        sqArray = (unsigned int *) (sq + params.sq_off.array);
+        cqHead = (unsigned int *) (cq + params.cq_off.head);
+        cqTail = (unsigned int *) (cq + params.cq_off.tail);
+        cqMask = (unsigned int *) (cq + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /*
+     * Collects the completed writes of the io_uring, waiting for at least one
+     * if asked to
+     *
+     * wait: True to wait for a completion
+     */
+    void reap( bool wait )
+    {
+        if ( wait )
+        {
+            syscall( __NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS,
+                     nullptr, 0 );
+        }
+        unsigned int head = *cqHead;
+        unsigned int tail = __atomic_load_n( cqTail, __ATOMIC_ACQUIRE );
+        for ( ; head != tail; ++head )
+        {
+            struct io_uring_cqe *cqe = &cqes[head & *cqMask];
+            unsigned int b = cqe->user_data & 0xffff;
+            if ( cqe->res != (int) (cqe->user_data >> 16) )
+            {
+                failed = true;
+            }
+            busy[b] = false;
+        }
+        __atomic_store_n( cqHead, head, __ATOMIC_RELEASE );
+    }
+
+    /*
+     * The loop of the writer thread of the fallback
+     */
+    void writerLoop()
+    {
+        unique_lock<mutex> guard(lock);
+        while ( true )
+        {
+            changed.wait( guard, [this] { return closing || !jobs.empty(); } );
+            if ( jobs.empty() )
+            {
+                return;
+            }
+            pair<unsigned int, unsigned long int> job = jobs.front();
+            unsigned long int off = jobOffsets.front();
+            guard.unlock();
+            ssize_t written = pwrite( fd, buffers[job.first], job.second, 
+                                      off );
+            guard.lock();
+            if ( written != (ssize_t) job.second )
+            {
+                failed = true;
+            }
+            jobs.pop_front();
+            jobOffsets.pop_front();
+            busy[job.first] = false;
+            changed.notify_all();
+        }
+    }
+
+    /*
+     * Starts writing a buffer to the file
+     *
+     * b  : The buffer
+     * len: The number of bytes to write
+     * off: The file offset
+     */
+    void submit( unsigned int b, unsigned long int len, unsigned long int off )
+    {
+        if ( ring < 0 )
+        {
+            lock_guard<mutex> guard(lock);
+            busy[b] = true;
+            jobs.push_back( make_pair(b, len) );
+            jobOffsets.push_back( off );
+            changed.notify_all();
+            return;
+        }
+        busy[b] = true;
+        unsigned int tail = *sqTail;
+        unsigned int index = tail & *sqMask;
+        struct io_uring_sqe *sqe = &sqes[index];
+        memset( sqe, 0, sizeof(*sqe) );
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = fd;
+        sqe->addr = (unsigned long int) buffers[b];
+        sqe->len = len;
+        sqe->off = off;
+        sqe->user_data = (len << 16) | b;
+        sqArray[index] = index;
+        __atomic_store_n( sqTail, tail + 1, __ATOMIC_RELEASE );
+        if ( syscall(__NR_io_uring_enter, ring, 1, 0, 0, nullptr, 0) != 1 )
+        {
+            failed = true;
+            busy[b] = false;
+        }
+    }
+
+    /*
+     * Waits until a buffer is free
+     *
+     * b: The buffer
+     */
+    void waitFree( unsigned int b )
+    {
+        if ( ring < 0 )
+        {
+            unique_lock<mutex> guard(lock);
+            changed.wait( guard, [this, b] { return !busy[b]; } );
+            return;
+        }
+        reap( false );
+        while ( busy[b] )
+        {
+            reap( true );
+        }
+    }
+
+public:
+    /*
+     * Constructor
+     *
+     * filename: The output file, created or truncated
+     */
+    AsyncWriter( const string &filename ) : failed(false), cur(0), used(0),
+                                            offset(0), ring(-1), 
+                                            closing(false)
+    {
+        direct = true;
+        fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT,
+                   0644 );
+        if ( fd < 0 )
+        {
+            direct = false;
+            fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        }
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            buffers[b] = (char *) aligned_alloc( ALIGNMENT, BUFFER_SIZE );
+            busy[b] = false;
+        }
+        if ( fd >= 0 && !setupRing() )
+        {
+            writer = thread( &AsyncWriter::writerLoop, this );
+        }
+    }
+
+    /*
+     * Destructor. Writes the rest of the data and waits for all writes.
+     */
+    ~AsyncWriter()
+    {
+        finish();
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            free( buffers[b] );
+        }
+    }
+
+    /*
+     * Writes the rest of the data, waits for all writes and closes the file.
+     * Returns true if all data was written.
+     */
+    bool finish()
+    {
+        if ( fd < 0 )
+        {
+            return !failed;
+        }
+
+        // O_DIRECT writes whole blocks, so the padding is cut off afterwards
+        unsigned long int len = used;
+        if ( direct )
+        {
+            len = (used + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            memset( buffers[cur] + used, 0, len - used );
+        }
+        if ( len > 0 )
+        {
+            submit( cur, len, offset );
+        }
+        for (unsigned int b = 0; b < NUM_BUFFERS; ++b)
+        {
+            waitFree( b );
+        }
+        if ( direct && ftruncate(fd, offset + used) != 0 )
+        {
+            failed = true;
+        }
+
+        if ( ring >= 0 )
+        {
+            munmap( sqes, numEntries * sizeof(struct io_uring_sqe) );
+            if ( cqPtr != sqPtr )
+            {
+                munmap( cqPtr, cqSize );
+            }
+            munmap( sqPtr, sqSize );
+            close( ring );
+        }
+        else
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                closing = true;
+                changed.notify_all();
+            }
+            writer.join();
+        }
+        close( fd );
+        fd = -1;
+        return !failed;
+    }
+
+    /*
+     * Returns true if the file could be opened
+     */
+    bool good() const
+    {
+        return fd >= 0;
+    }
+
+    /*
+     * Returns the name of the mechanism doing the writes
+     */
+    const char *backend() const
+    {
+        return ring >= 0 ? "io_uring" : "a writer thread";
+    }
+
+    /*
+     * Appends data to the file
+     *
+     * data: The data
+     * len : The number of bytes
+     */
+    void write( const char *data, unsigned long int len )
+    {
+        while ( len > 0 )
+        {
+            unsigned long int n = min( len, BUFFER_SIZE - used );
+            memcpy( buffers[cur] + used, data, n );
+            used += n;
+            data += n;
+            len -= n;
+            if ( used == BUFFER_SIZE )
+            {
+                submit( cur, BUFFER_SIZE, offset );
+                offset += BUFFER_SIZE;
+                cur = (cur + 1) % NUM_BUFFERS;
+                used = 0;
+                waitFree( cur );
+            }
+        }
+    }
+};
+
+// Where printMember writes the independent nodes, nullptr for the console
+AsyncWriter *memberOutput = nullptr;
+
+/*
+ * Prints a member of the independent set followed by a space, to the output
+ * file if one was given and to the console otherwise
+ *
+ * enc: The binary encoding of the k-mer
+ * k  : The length of the k-mer
+ */
+void printMember( unsigned long int enc, int k )
+{
+    if ( memberOutput == nullptr )
+    {
+        printKmer( enc, k );
+        cerr << ' ';
+        return;
+    }
+    char base[4] = {'A', 'C', 'G', 'T'};
+    char kmer[k + 1];
+    kmer[k] = ' ';
+    for (int i = k - 1; i >= 0; --i)
+    {
+        kmer[i] = base[enc & 3];
+        enc = enc >> 2;
+    }
+    memberOutput->write( kmer, k + 1 );
+}
+
 /*
  * Calculates the Hamming distance between 2 k-mers
  *
@@ -66,8 +484,10 @@ int hammingDist( const unsigned long int s1, const unsigned long int s2,
 
 /*
  * Reports the time and space usage
+ *
+ * out: The stream to write the report to
  */
-void reportPerformance()
+void reportPerformance( ostream &out = cerr )
 {
     string temp;
     unsigned long int utime, stime, vmpeak, vmhwm;
@@ -98,119 +518,603 @@ void reportPerformance()
     space_stream >> vmhwm;
     space_stream.close();
 
-    cerr << "Performance Report\n"
-         << "Time in user mode:        " 
-         << utime / sysconf(_SC_CLK_TCK) << " sec\n"
-         << "Time in kernel mode:      " 
-         << stime / sysconf(_SC_CLK_TCK) << " sec\n"
-         << "Peak virtual memory size: " << vmpeak << " kB\n"
-         << "Peak resident set size:   " << vmhwm << " kB\n\n";
+    out << "Performance Report\n"
+        << "Time in user mode:        " 
+        << utime / sysconf(_SC_CLK_TCK) << " sec\n"
+        << "Time in kernel mode:      " 
+        << stime / sysconf(_SC_CLK_TCK) << " sec\n"
+        << "Peak virtual memory size: " << vmpeak << " kB\n"
+        << "Peak resident set size:   " << vmhwm << " kB\n\n";
 }
 
 /*
- * Implementation of the Simple Pairwise Comparison method with alphabetical
- * order of k-mer iteration
- *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * Options passed from the command line to the drivers
  */
-void doPairwiseCmp( const int k, const int d )
+struct RunOptions
 {
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    vector<unsigned long int> MIS;
-    bool isCovered = false;
-    
-    cerr << "\nList of independent nodes: " << endl;
-    for ( unsigned long int i = 0; i < kmerSpaceSize; ++i )
+    double timeLimit;              // Wall-clock budget in seconds, 0 for none
+    string checkpointFile;         // Where an interrupted run saves its state
+    string resultFile;             // Where a completed run saves its MIS
+    string witnessFile;            // Where a completed run saves witnesses
+    unsigned int seed;             // The seed of the random iteration order
+    unsigned long int resumeCursor;      // The iteration to resume from
+    vector<unsigned long int> resumeMIS; // The independent set to resume from
+
+    RunOptions() : timeLimit(0), checkpointFile("kmerspace.ckpt"), 
+                   seed(time(nullptr)), resumeCursor(0) {}
+};
+
+// Set when a scan is stopped by the time limit
+bool scanStopped = false;
+
+/*
+ * A wall-clock budget polled by the main scans. The clock is only read every
+ * few calls to keep the check cheap in tight loops.
+ */
+class TimeBudget
+{
+private:
+    chrono::steady_clock::time_point end; // The point in time the budget ends
+    bool limited;                         // False if there is no budget
+    unsigned int calls;                   // Calls since the clock was read
+    unsigned int interval;                // Calls between clock reads
+
+public:
+    /*
+     * Constructor
+     *
+     * seconds: The budget in seconds, 0 for no budget
+     * every  : The number of calls between clock reads
+     */
+    TimeBudget( double seconds, unsigned int every = 1024 )
     {
-        for ( const unsigned long int &j : MIS )
-        {
-            if ( hammingDist(i, j, k, d) <= d )
-            {
-                isCovered = true;
-                break;
-            }
-        }
+        limited = seconds > 0;
+        end = chrono::steady_clock::now() + 
+              chrono::duration_cast<chrono::steady_clock::duration>(
+                  chrono::duration<double>(seconds));
+        calls = 0;
+        interval = every;
+    }
 
-        if ( isCovered )
+    /*
+     * Returns true if the budget has run out
+     */
+    bool expired()
+    {
+        if ( !limited || ++calls < interval )
         {
-            isCovered = false;
-            continue;
+            return false;
         }
-
-        printKmer( i, k );
-        cerr << ' ';
-        MIS.push_back( i );
+        calls = 0;
+        return chrono::steady_clock::now() >= end;
     }
 
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
-}
+    /*
+     * Returns true if the budget has run out, reading the clock now. For
+     * steps too few or too long to be polled with expired().
+     */
+    bool expiredNow() const
+    {
+        return limited && chrono::steady_clock::now() >= end;
+    }
+};
 
 /*
- * Implementation of the Simple Pairwise Comparison method with random order of
- * k-mer iteration
+ * Saves the state of a scan stopped by the time limit, so that it can be 
+ * resumed with --resume
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * opts  : The options of the run
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * k     : The length of the k-mer
+ * d     : The maximum Hamming distance allowed
+ * cursor: The next iteration of the main scan
+ * MIS   : The current independent set
  */
-void doRandPairwiseCmp( const int k, const int d )
+void saveCheckpoint( const RunOptions &opts, int method, int order, int k, 
+                     int d, unsigned long int cursor, 
+                     const vector<unsigned long int> &MIS )
 {
-    sleep(1);
-    srand( time(nullptr) );
-    unsigned long int kmerSpaceSize = 1ul << (2 * k);
-    vector<unsigned long int> MIS;
-    bool isCovered = false;
-    unordered_set<unsigned long int> space;
-    for ( unsigned long int i = 0; i < kmerSpaceSize; ++i )
+    MISFileHeader header;
+    header.metric = METRIC;
+    header.complete = 0;
+    header.method = method;
+    header.order = order;
+    header.k = k;
+    header.d = d;
+    header.cursor = cursor;
+    header.seed = opts.seed;
+    scanStopped = true;
+    cerr << "\nTime limit reached at iteration " << cursor << " of the scan. "
+         << "The independent set found so far is valid but not necessarily "
+         << "maximal.";
+    if ( writeMISFile(opts.checkpointFile, header, MIS) )
     {
-        space.insert(i);
+        cerr << "\nThe state was saved to " << opts.checkpointFile 
+             << "; run with --resume " << opts.checkpointFile 
+             << " to continue.";
     }
-    
-    cerr << "\nList of independent nodes: " << endl;
-    while ( !space.empty() )
+    else
     {
-        auto it = space.begin();
-        advance(it, rand() % space.size());
-        unsigned long int kmer = *it;
-        space.erase(it);
-        
-        for ( const unsigned long int &j : MIS )
-        {
-            if ( hammingDist(kmer, j, k, d) <= d )
-            {
-                isCovered = true;
-                break;
-            }
-        }
-
-        if ( isCovered )
-        {
-            isCovered = false;
-            continue;
-        }
-
-        printKmer( kmer, k );
-        cerr << ' ';
-        MIS.push_back( kmer );
+        cerr << "\nFailed to save the state to " << opts.checkpointFile << '.';
     }
+}
 
-    cerr << "\nThe graph has an independent set of size " << MIS.size() 
-         << ".\n\n";
-    reportPerformance();
+/*
+ * Prints the members of a resumed independent set
+ *
+ * opts: The options of the run
+ * k   : The length of the k-mer
+ */
+void printResumed( const RunOptions &opts, int k )
+{
+    for ( const unsigned long int &m : opts.resumeMIS )
+    {
+        printMember( m, k );
+    }
 }
 
 /*
- * A data structure to store the mapping information for kmers. The array is 
- * chopped into subarrays to avoid failures of dynamic allocation.
+ * An array holding one member index per k-mer with just enough bits to hold
+ * the number of members. The all-ones value marks a k-mer without a witness.
  */
-class MappingArray
+class WitnessArray
 {
 private:
-    char **aptrs;               // An array of pointers to subarrays
-    unsigned long int size;     // The capacity of the whole array in elements
-    unsigned long int num_subs; // Number of subarrays
+    vector<unsigned long int> words; // The packed indices
+    int bits;                        // The bits per index
+
+public:
+    /*
+     * Constructor
+     *
+     * num_kmers  : The number of k-mers
+     * num_members: The number of members to index
+     */
+    WitnessArray( unsigned long int num_kmers, unsigned long int num_members )
+    {
+        bits = 1;
+        while ( bits < 63 && (num_members >> bits) != 0 )
+        {
+            bits++;
+        }
+        words.assign( (num_kmers * bits + 63) / 64, ~0ul );
+    }
+
+    /*
+     * Returns the value marking a k-mer without a witness
+     */
+    unsigned long int none() const
+    {
+        return (1ul << bits) - 1;
+    }
+
+    /*
+     * Returns the bits per index
+     */
+    int getBits() const
+    {
+        return bits;
+    }
+
+    /*
+     * Returns the packed indices
+     */
+    const vector<unsigned long int> &getWords() const
+    {
+        return words;
+    }
+
+    /*
+     * Overload [] operator to return the witness of a k-mer
+     *
+     * sub: The encoding of the k-mer
+     */
+    unsigned long int operator[]( const unsigned long int sub ) const
+    {
+        unsigned long int pos = sub * bits;
+        unsigned long int value = words[pos / 64] >> (pos % 64);
+        if ( pos % 64 + bits > 64 )
+        {
+            value |= words[pos / 64 + 1] << (64 - pos % 64);
+        }
+        return value & none();
+    }
+
+    /*
+     * Sets the witness of a k-mer
+     *
+     * sub   : The encoding of the k-mer
+     * member: The index of the member
+     */
+    void setWitness( const unsigned long int sub, unsigned long int member )
+    {
+        unsigned long int pos = sub * bits;
+        words[pos / 64] &= ~(none() << (pos % 64));
+        words[pos / 64] |= member << (pos % 64);
+        if ( pos % 64 + bits > 64 )
+        {
+            int low = 64 - pos % 64;
+            words[pos / 64 + 1] &= ~(none() >> low);
+            words[pos / 64 + 1] |= member >> low;
+        }
+    }
+};
+
+/*
+ * Sets a member as the witness of the k-mers without one that differ from a
+ * k-mer in at most d positions, all at or after a given position
+ *
+ * enc    : The binary encoding of the k-mer
+ * k      : The length of the k-mer
+ * d      : The number of substitutions left
+ * first  : The first position that may be substituted
+ * member : The index of the member
+ * witness: The witnesses of all k-mers
+ */
+void markWitnessBall( unsigned long int enc, int k, int d, int first, 
+                      unsigned long int member, WitnessArray &witness )
+{
+    for (int j = first; j < k && d > 0; ++j)
+    {
+        for (unsigned long int l = 1; l < 4; ++l)
+        {
+            unsigned long int x = enc ^ (l << (2 * j));
+            if ( witness[x] == witness.none() )
+            {
+                witness.setWitness( x, member );
+            }
+            markWitnessBall( x, k, d - 1, j + 1, member, witness );
+        }
+    }
+}
+
+/*
+ * Saves a witness for every k-mer: the first member, in the order of the MIS,
+ * within distance d of it. A verifier can then check maximality with one
+ * distance calculation per k-mer (misSetOps --verify).
+ *
+ * filename: The output file
+ * k       : The length of the k-mer
+ * d       : The maximum Hamming distance allowed
+ * MIS     : The maximal independent set
+ */
+void saveWitness( const string &filename, int k, int d, 
+                  const vector<unsigned long int> &MIS )
+{
+    unsigned long int num_kmers = 1ul << (2 * k);
+    WitnessArray witness(num_kmers, MIS.size());
+    for (unsigned long int m = 0; m < MIS.size(); ++m)
+    {
+        witness.setWitness( MIS[m], m );
+        markWitnessBall( MIS[m], k, d, 0, m, witness );
+    }
+
+    unsigned long int missing = 0;
+    for (unsigned long int i = 0; i < num_kmers; ++i)
+    {
+        missing += witness[i] == witness.none();
+    }
+    if ( missing > 0 )
+    {
+        cerr << "\n" << missing << " k-mers are not covered, so no witness "
+             << "file was written.";
+        return;
+    }
+
+    WitnessFileHeader header;
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, "KWIT", 4 );
+    header.version = 1;
+    header.metric = METRIC;
+    header.bits = witness.getBits();
+    header.k = k;
+    header.d = d;
+    header.size = MIS.size();
+    const vector<unsigned long int> &words = witness.getWords();
+    ofstream out_stream(filename.c_str(), ios_base::out | ios_base::binary);
+    out_stream.write( (const char *) &header, sizeof(header) );
+    out_stream.write( (const char *) MIS.data(), MIS.size() * 8 );
+    out_stream.write( (const char *) words.data(), words.size() * 8 );
+    if ( !out_stream )
+    {
+        cerr << "\nFailed to save the witnesses to " << filename << '.';
+        return;
+    }
+    cerr << "\nThe witnesses were saved to " << filename << " (" 
+         << witness.getBits() << " bits per k-mer).";
+}
+
+/*
+ * Saves the independent set of a completed run and its performance report to
+ * the result cache, if one is in use, and the witnesses of the set if they
+ * were requested
+ *
+ * opts  : The options of the run
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * k     : The length of the k-mer
+ * d     : The maximum Hamming distance allowed
+ * MIS   : The maximal independent set
+ */
+void saveResult( const RunOptions &opts, int method, int order, int k, int d, 
+                 const vector<unsigned long int> &MIS )
+{
+    if ( !opts.witnessFile.empty() && !scanStopped )
+    {
+        saveWitness( opts.witnessFile, k, d, MIS );
+    }
+    if ( opts.resultFile.empty() || scanStopped )
+    {
+        return;
+    }
+    MISFileHeader header;
+    header.metric = METRIC;
+    header.complete = 1;
+    header.method = method;
+    header.order = order;
+    header.k = k;
+    header.d = d;
+    header.cursor = 0;
+    header.seed = opts.seed;
+    if ( !writeMISFile(opts.resultFile, header, MIS) )
+    {
+        cerr << "\nFailed to save the result to " << opts.resultFile << '.';
+        return;
+    }
+    string perfFile = opts.resultFile + ".perf";
+    ofstream perf_stream(perfFile.c_str(), ios_base::out);
+    reportPerformance( perf_stream );
+    cerr << "\nThe result was saved to " << opts.resultFile << '.';
+}
+
+/*
+ * Hashes a buffer with 64-bit FNV-1a
+ *
+ * data: The buffer
+ * len : The length of the buffer in bytes
+ * hash: The hash of the preceding data, if any
+ */
+unsigned long int fnv1a( const char *data, size_t len, 
+                         unsigned long int hash = 14695981039346656037ul )
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash = (hash ^ (unsigned char) data[i]) * 1099511628211ul;
+    }
+    return hash;
+}
+
+/*
+ * Returns an identifier of this build of the program, the hash of its own
+ * executable, or of the compilation time if the executable cannot be read
+ */
+unsigned long int getBuildId()
+{
+    ifstream in_stream("/proc/self/exe", ios_base::in | ios_base::binary);
+    if ( !in_stream )
+    {
+        const char *stamp = __DATE__ " " __TIME__;
+        return fnv1a( stamp, strlen(stamp) );
+    }
+    unsigned long int hash = fnv1a( nullptr, 0 );
+    vector<char> buffer(1 << 16);
+    while ( in_stream.read(buffer.data(), buffer.size()) || 
+            in_stream.gcount() > 0 )
+    {
+        hash = fnv1a( buffer.data(), in_stream.gcount(), hash );
+    }
+    return hash;
+}
+
+/*
+ * Returns the path of the cache entry of a configuration. The name is the hash
+ * of the configuration and the build, so a rebuilt program starts afresh.
+ *
+ * dir   : The cache directory
+ * k     : The length of the k-mer
+ * d     : The maximum Hamming distance allowed
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * seed  : The seed of the random iteration order, ignored for alphabetical
+ */
+string getCacheEntry( const string &dir, int k, int d, int method, int order, 
+                      unsigned int seed )
+{
+    string config = string(1, METRIC) + ' ' + to_string(k) + ' ' + 
+                    to_string(d) + ' ' + to_string(method) + ' ' + 
+                    to_string(order) + ' ' + 
+                    to_string(order == 1 ? seed : 0) + ' ' + 
+                    to_string(getBuildId());
+    char name[32];
+    snprintf( name, sizeof(name), "%016lx.kmis", 
+              fnv1a(config.data(), config.size()) );
+    return dir + '/' + name;
+}
+
+/*
+ * Looks up a configuration in the result cache. A completed entry is printed
+ * and true is returned; a snapshot of a stopped run is loaded into the options
+ * as a warm start. Either way the run saves its state to the entry.
+ *
+ * dir   : The cache directory
+ * k     : The length of the k-mer
+ * d     : The maximum Hamming distance allowed
+ * method: The approach chosen in main
+ * order : The iteration order chosen in main
+ * opts  : The options of the run
+ */
+bool lookupCache( const string &dir, int k, int d, int method, int order, 
+                  RunOptions &opts )
+{
+    mkdir( dir.c_str(), 0755 );
+    string entry = getCacheEntry( dir, k, d, method, order, opts.seed );
+    opts.checkpointFile = entry;
+    opts.resultFile = entry;
+
+    MISFileHeader header;
+    vector<unsigned long int> MIS;
+    if ( !readMISFile(entry, header, MIS) || header.metric != METRIC || 
+         header.k != k || header.d != d )
+    {
+        return false;
+    }
+    if ( !header.complete )
+    {
+        opts.resumeMIS = MIS;
+        opts.resumeCursor = header.cursor;
+        opts.seed = header.seed;
+        cerr << "Warm start from " << entry << " at iteration " 
+             << header.cursor << " with " << MIS.size() 
+             << " independent nodes.\n";
+        return false;
+    }
+
+    cerr << "Found the result in " << entry << ".\n";
+    cerr << "\nList of independent nodes: " << endl;
+    for ( const unsigned long int &m : MIS )
+    {
+        printMember( m, k );
+    }
+    if ( !opts.witnessFile.empty() )
+    {
+        saveWitness( opts.witnessFile, k, d, MIS );
+    }
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\nThe run that computed it:\n";
+    string perfFile = entry + ".perf";
+    ifstream perf_stream(perfFile.c_str(), ios_base::in);
+    cerr << perf_stream.rdbuf();
+    return true;
+}
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with alphabetical
+ * order of k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doPairwiseCmp( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    bool isCovered = false;
+    TimeBudget budget(opts.timeLimit);
+    
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    for ( unsigned long int i = opts.resumeCursor; i < kmerSpaceSize; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 1, 2, k, d, i, MIS );
+            break;
+        }
+        for ( const unsigned long int &j : MIS )
+        {
+            if ( hammingDist(i, j, k, d) <= d )
+            {
+                isCovered = true;
+                break;
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( i, k );
+        MIS.push_back( i );
+    }
+
+    saveResult( opts, 1, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with random order of
+ * k-mer iteration
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
+ */
+void doRandPairwiseCmp( const int k, const int d, const RunOptions &opts )
+{
+    sleep(1);
+    srand( opts.seed );
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    bool isCovered = false;
+    TimeBudget budget(opts.timeLimit);
+    unordered_set<unsigned long int> space;
+    for ( unsigned long int i = 0; i < kmerSpaceSize; ++i )
+    {
+        space.insert(i);
+    }
+
+    // K-mers visited before the checkpoint but not in the MIS are covered
+    for ( const unsigned long int &m : MIS )
+    {
+        space.erase(m);
+    }
+    
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    while ( !space.empty() )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 1, 1, k, d, kmerSpaceSize - space.size(), 
+                            MIS );
+            break;
+        }
+        auto it = space.begin();
+        advance(it, rand() % space.size());
+        unsigned long int kmer = *it;
+        space.erase(it);
+        
+        for ( const unsigned long int &j : MIS )
+        {
+            if ( hammingDist(kmer, j, k, d) <= d )
+            {
+                isCovered = true;
+                break;
+            }
+        }
+
+        if ( isCovered )
+        {
+            isCovered = false;
+            continue;
+        }
+
+        printMember( kmer, k );
+        MIS.push_back( kmer );
+    }
+
+    saveResult( opts, 1, 1, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * A data structure to store the mapping information for kmers. The array is 
+ * chopped into subarrays to avoid failures of dynamic allocation.
+ */
+class MappingArray
+{
+private:
+    char **aptrs;               // An array of pointers to subarrays
+    unsigned long int size;     // The capacity of the whole array in elements
+    unsigned long int num_subs; // Number of subarrays
     unsigned long int sub_size; // Size of a subarray in bytes
 
 public:
@@ -322,10 +1226,11 @@ bool askNeighbors( const unsigned long int enc, const int k, const int d,
  * Implementation of the heuristic method with alphabetical order of k-mer
  * iteration
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
  */
-void doHeuristic( const int k, const int d )
+void doHeuristic( const int k, const int d, const RunOptions &opts )
 {
     unsigned long int kmerSpaceSize = 1ul << (2 * k);
     vector<unsigned long int> MIS;
@@ -334,20 +1239,50 @@ void doHeuristic( const int k, const int d )
     vector<int> dg;
     vector<int> dt;
 
-    MIS.push_back( 0 );
-    da.push_back( 0 );
-    dc.push_back( k );
-    dg.push_back( k );
-    dt.push_back( k );
+    if ( opts.resumeMIS.empty() )
+    {
+        MIS.push_back( 0 );
+    }
+    else
+    {
+        MIS = opts.resumeMIS;
+    }
+    for ( const unsigned long int &m : MIS )
+    {
+        int ds[] = {k, k, k, k};
+        unsigned long int temp_v = m;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+        da.push_back( ds[0] );
+        dc.push_back( ds[1] );
+        dg.push_back( ds[2] );
+        dt.push_back( ds[3] );
+    }
     MappingArray mapping(kmerSpaceSize / 4);
+    for ( const unsigned long int &m : MIS )
+    {
+        mapping.setMap( m, m );
+    }
+    TimeBudget budget(opts.timeLimit);
 
     cerr << "\nList of independent nodes: " << endl;
-    printKmer( 0, k );
-    cerr << ' ';
+    for ( const unsigned long int &m : MIS )
+    {
+        printMember( m, k );
+    }
     bool isCovered = false;
 
-    for (unsigned long int i = 1; i < kmerSpaceSize; ++i)
+    unsigned long int start = opts.resumeMIS.empty() ? 1 : opts.resumeCursor;
+    for (unsigned long int i = start; i < kmerSpaceSize; ++i)
     {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 2, 2, k, d, i, MIS );
+            break;
+        }
         if ( askNeighbors(i, k, d, mapping) )
         {
             continue;
@@ -388,8 +1323,7 @@ void doHeuristic( const int k, const int d )
             continue;
         }
 
-        printKmer( i, k );
-        cerr << ' ';
+        printMember( i, k );
         MIS.push_back( i );
         da.push_back( ds[0] );
         dc.push_back( ds[1] );
@@ -398,6 +1332,7 @@ void doHeuristic( const int k, const int d )
         mapping.setMap( i, i );
     }
 
+    saveResult( opts, 2, 2, k, d, MIS );
     cerr << "\nThe graph has an independent set of size " << MIS.size() 
          << ".\n\n";
     reportPerformance();
@@ -406,15 +1341,20 @@ void doHeuristic( const int k, const int d )
 /*
  * Implementation of the heuristic method with random order of k-mer iteration
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
  */
-void doRandHeuristic( const int k, const int d )
+void doRandHeuristic( const int k, const int d, const RunOptions &opts )
 {
     sleep(1);
-    srand( time(nullptr) );
+    srand( opts.seed );
     unsigned long int kmerSpaceSize = 1ul << (2 * k);
     unsigned long int kmer = rand() % kmerSpaceSize;
+    if ( !opts.resumeMIS.empty() )
+    {
+        kmer = opts.resumeMIS[0];
+    }
     vector<unsigned long int> MIS;
     vector<int> da;
     vector<int> dc;
@@ -430,26 +1370,48 @@ void doRandHeuristic( const int k, const int d )
     {
         space.insert(i);
     }
-    space.erase(kmer);
     MIS.push_back(kmer);
-    int ds[] = {k, k, k, k};
-    unsigned long int temp_v = kmer;
-    for (int j = 0; j < k; ++j)
+    for ( unsigned long int j = 1; j < opts.resumeMIS.size(); ++j )
     {
-        ds[temp_v & 3]--;
-        temp_v = temp_v >> 2;
+        MIS.push_back( opts.resumeMIS[j] );
     }
-    da.push_back(ds[0]);
-    dc.push_back(ds[1]);
-    dg.push_back(ds[2]);
-    dt.push_back(ds[3]);
-
-    cerr << "\nList of independent nodes: " << endl;
-    printKmer( kmer, k );
-    cerr << ' ';
-    bool isCovered = false;
-    while ( !space.empty() )
+    int ds[] = {k, k, k, k};
+    unsigned long int temp_v;
+    for ( const unsigned long int &m : MIS )
+    {
+        ds[0] = k;
+        ds[1] = k;
+        ds[2] = k;
+        ds[3] = k;
+        temp_v = m;
+        for (int j = 0; j < k; ++j)
+        {
+            ds[temp_v & 3]--;
+            temp_v = temp_v >> 2;
+        }
+        da.push_back(ds[0]);
+        dc.push_back(ds[1]);
+        dg.push_back(ds[2]);
+        dt.push_back(ds[3]);
+        space.erase(m);
+        mapping.setMap(m, m);
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    for ( const unsigned long int &m : MIS )
     {
+        printMember( m, k );
+    }
+    bool isCovered = false;
+    while ( !space.empty() )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 2, 1, k, d, kmerSpaceSize - space.size(), 
+                            MIS );
+            break;
+        }
         auto it = space.begin();
         advance(it, rand() % space.size());
         unsigned long int kmer = *it;
@@ -498,8 +1460,7 @@ void doRandHeuristic( const int k, const int d )
             continue;
         }
 
-        printKmer( kmer, k );
-        cerr << ' ';
+        printMember( kmer, k );
         MIS.push_back( kmer );
         da.push_back( ds[0] );
         dc.push_back( ds[1] );
@@ -508,6 +1469,7 @@ void doRandHeuristic( const int k, const int d )
         mapping.setMap( kmer, kmer );
     }
 
+    saveResult( opts, 2, 1, k, d, MIS );
     cerr << "\nThe graph has an independent set of size " << MIS.size() 
          << ".\n\n";
     reportPerformance();
@@ -642,71 +1604,98 @@ void getNeighbor( unsigned long int enc, int k,
     n.erase(enc);
 }
 
+/*
+ * Marks the k-mers within distance d of a new independent node in the dist
+ * array by BFS
+ *
+ * enc      : The binary encoding of the independent k-mer
+ * k        : The length of the k-mer
+ * d        : The maximum Hamming distance allowed
+ * dist_kmer: The dist array for k-mers
+ */
+void markBall( unsigned long int enc, int k, int d, DistArray &dist_kmer )
+{
+    // Do BFS
+    deque<unsigned long int> Q; // Initialize an empty queue
+    Q.push_back(enc);
+
+    // Keep the search history
+    unordered_map<unsigned long int, unsigned int> hist;
+    hist.emplace( enc, 0 );
+
+    dist_kmer.setDist(enc, 0);
+    while ( !Q.empty() )
+    {
+        auto q0 = hist.find( Q[0] );
+        if ( q0->second + 1 > d )
+        {
+            break;
+        }
+        unordered_set<unsigned long int> neighbors;
+        getNeighbor( Q[0], k, neighbors );
+
+        for ( auto &j : neighbors )
+        {
+            if ( hist.find(j) != hist.end() )
+            {
+                continue;
+            }
+            unsigned int targetDist;
+            targetDist = dist_kmer[j];
+            if ( targetDist == (d + 1)/2 - 1 ||
+                 (targetDist != (d + 1)/2 &&
+                  targetDist > q0->second + 1) )
+            {
+                dist_kmer.setDist( j, q0->second + 1 );
+                Q.push_back(j);
+                hist.emplace( j, q0->second + 1 );
+            }
+        }
+        Q.pop_front();
+    }
+}
+
 /*
  * Implementation of the BFS method with alphabetical order of k-mer iteration
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
  */
-void doBFS( const int k, const int d )
+void doBFS( const int k, const int d, const RunOptions &opts )
 {
     // Initialize dist array for BFS
     unsigned long int num_kmers = 1ul << (2 * k);
     DistArray dist_kmer(num_kmers, d);
 
-    unsigned long int num_indep_nodes = 0;
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
     cerr << "\nList of independent nodes: " << endl;
-    for ( unsigned long int i = 0; i < num_kmers; ++i )
+    printResumed( opts, k );
+    for ( unsigned long int i = opts.resumeCursor; i < num_kmers; ++i )
     {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 3, 2, k, d, i, MIS );
+            break;
+        }
         if ( dist_kmer[i] != (d + 1)/2 - 1 )
         {
             continue;
         }
-        printKmer(i, k);
-        cerr << ' ';
-        num_indep_nodes++;
-
-        // Do BFS
-        deque<unsigned long int> Q; // Initialize an empty queue
-        Q.push_back(i);
-
-        // Keep the search history
-        unordered_map<unsigned long int, unsigned int> hist;
-        hist.emplace( i, 0 );
-
-        dist_kmer.setDist(i, 0);
-        while ( !Q.empty() )
-        {
-            auto q0 = hist.find( Q[0] );
-            if ( q0->second + 1 > d )
-            {
-                break;
-            }
-            unordered_set<unsigned long int> neighbors;
-            getNeighbor( Q[0], k, neighbors );
+        printMember( i, k );
+        MIS.push_back( i );
 
-            for ( auto &j : neighbors )
-            {
-                if ( hist.find(j) != hist.end() )
-                {
-                    continue;
-                }
-                unsigned int targetDist;
-                targetDist = dist_kmer[j];
-                if ( targetDist == (d + 1)/2 - 1 ||
-                     (targetDist != (d + 1)/2 &&
-                      targetDist > q0->second + 1) )
-                {
-                    dist_kmer.setDist( j, q0->second + 1 );
-                    Q.push_back(j);
-                    hist.emplace( j, q0->second + 1 );
-                }
-            }
-            Q.pop_front();
-        }
+        markBall( i, k, d, dist_kmer );
     }
 
-    cerr << "\nThe graph has an independent set of size " << num_indep_nodes 
+    saveResult( opts, 3, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
          << ".\n\n";
     reportPerformance();
 }
@@ -714,13 +1703,14 @@ void doBFS( const int k, const int d )
 /*
  * Implementation of the BFS method with random order of k-mer iteration
  *
- * k: The length of the k-mer
- * d: The maximum edit distance allowed
+ * k   : The length of the k-mer
+ * d   : The maximum edit distance allowed
+ * opts: The options of the run
  */
-void doRandBFS( const int k, const int d )
+void doRandBFS( const int k, const int d, const RunOptions &opts )
 {
     sleep(1);
-    srand( time(nullptr) );
+    srand( opts.seed );
 
     // Initialize dist array for BFS
     unsigned long int num_kmers = 1ul << (2 * k);
@@ -731,10 +1721,22 @@ void doRandBFS( const int k, const int d )
         space.insert(i);
     }
 
-    unsigned long int num_indep_nodes = 0;
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
     cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
     while ( !space.empty() )
     {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 3, 1, k, d, num_kmers - space.size(), MIS );
+            break;
+        }
         auto it = space.begin();
         advance(it, rand() % space.size());
         unsigned long int i = *it;
@@ -744,112 +1746,750 @@ void doRandBFS( const int k, const int d )
         {
             continue;
         }
-        printKmer(i, k);
-        cerr << ' ';
-        num_indep_nodes++;
+        printMember( i, k );
+        MIS.push_back( i );
 
-        // Do BFS
-        deque<unsigned long int> Q; // Initialize an empty queue
-        Q.push_back(i);
+        markBall( i, k, d, dist_kmer );
+    }
+
+    saveResult( opts, 3, 1, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
 
-        // Keep the search history
-        unordered_map<unsigned long int, unsigned int> hist;
-        hist.emplace( i, 0 );
+/*
+ * Multiplies every symbol of a vector over GF(4) by a scalar. Vectors use the
+ * k-mer encoding, 2 bits per symbol, where the symbol with bits (h, l) is the
+ * field element l + h*w and w^2 = w + 1. Addition of vectors is XOR.
+ *
+ * v: The vector
+ * a: The scalar, 0 to 3
+ */
+unsigned long int gfScale( unsigned long int v, unsigned int a )
+{
+    unsigned long int l = v & 0x5555555555555555ul;
+    unsigned long int h = (v >> 1) & 0x5555555555555555ul;
+    switch ( a )
+    {
+        case 0:
+            return 0;
+        case 1:
+            return v;
+        case 2:
+            // w * (l + h*w) = h + (l + h)*w
+            return h | ((l ^ h) << 1);
+        default:
+            // w^2 * (l + h*w) = (l + h) + l*w
+            return (l ^ h) | (l << 1);
+    }
+}
 
-        dist_kmer.setDist(i, 0);
-        while ( !Q.empty() )
+/*
+ * Builds the parity-check matrix of a linear code over GF(4) of length k and
+ * minimum distance at least d + 1 by the greedy Gilbert-Varshamov 
+ * construction: with r check symbols, the columns are picked in increasing 
+ * order among the vectors of GF(4)^r that are not a combination of d - 1 or
+ * fewer columns picked before, so that any d columns are linearly 
+ * independent. The smallest r for which k columns exist is used. For d = 1
+ * this is the parity code and for d = 2 a shortened Hamming code. Returns 
+ * the columns, each a vector of r symbols.
+ *
+ * k: The length of the code
+ * d: The maximum Hamming distance allowed
+ */
+vector<unsigned long int> buildParityCheck( const int k, const int d )
+{
+    vector<unsigned long int> columns;
+
+    // For d = 1 a single check symbol suffices, columns may repeat
+    if ( d == 1 )
+    {
+        columns.assign( k, 1 );
+        return columns;
+    }
+    for (int r = 1; r < k; ++r)
+    {
+        // The least number of columns summing to each syndrome, up to d - 1
+        unsigned long int num_syndromes = 1ul << (2 * r);
+        vector<unsigned char> weight(num_syndromes, d);
+        weight[0] = 0;
+        columns.clear();
+        for ( unsigned long int v = 1; v < num_syndromes && 
+              (int) columns.size() < k; ++v )
         {
-            auto q0 = hist.find( Q[0] );
-            if ( q0->second + 1 > d )
+            if ( weight[v] < d )
+            {
+                continue;
+            }
+            columns.push_back( v );
+            for ( unsigned long int s = 0; s < num_syndromes; ++s )
+            {
+                if ( weight[s] + 1 >= d )
+                {
+                    continue;
+                }
+                for (unsigned int a = 1; a < 4; ++a)
+                {
+                    unsigned long int t = s ^ gfScale(v, a);
+                    if ( weight[s] + 1 < weight[t] )
+                    {
+                        weight[t] = weight[s] + 1;
+                    }
+                }
+            }
+        }
+        if ( (int) columns.size() == k )
+        {
+            return columns;
+        }
+    }
+
+    // Only the zero codeword is left with k check symbols
+    columns.clear();
+    for (int j = 0; j < k; ++j)
+    {
+        columns.push_back( 1ul << (2 * j) );
+    }
+    return columns;
+}
+
+/*
+ * Computes a generator matrix of the code with the given parity-check matrix,
+ * i.e. a basis of its null space over GF(4), by Gaussian elimination. Returns
+ * the basis vectors as k-mer encodings.
+ *
+ * columns: The columns of the parity-check matrix
+ * k      : The length of the code
+ */
+vector<unsigned long int> buildGenerator( const vector<unsigned long int> 
+                                          &columns, const int k )
+{
+    // The field inverses of 1, w and w^2
+    const unsigned int inverse[4] = {0, 1, 3, 2};
+
+    // Transpose the columns into rows of k symbols each
+    int r = 0;
+    for ( const unsigned long int &c : columns )
+    {
+        while ( (c >> (2 * r)) != 0 )
+        {
+            r++;
+        }
+    }
+    vector<unsigned long int> rows(r, 0);
+    for (int j = 0; j < k; ++j)
+    {
+        for (int i = 0; i < r; ++i)
+        {
+            rows[i] |= ((columns[j] >> (2 * i)) & 3) << (2 * j);
+        }
+    }
+
+    // Reduce the rows to reduced row echelon form
+    vector<int> pivots;
+    int rank = 0;
+    for (int j = 0; j < k && rank < r; ++j)
+    {
+        int p = rank;
+        while ( p < r && ((rows[p] >> (2 * j)) & 3) == 0 )
+        {
+            p++;
+        }
+        if ( p == r )
+        {
+            continue;
+        }
+        swap( rows[p], rows[rank] );
+        unsigned int lead = (rows[rank] >> (2 * j)) & 3;
+        rows[rank] = gfScale( rows[rank], inverse[lead] );
+        for (int i = 0; i < r; ++i)
+        {
+            unsigned int a = (rows[i] >> (2 * j)) & 3;
+            if ( i != rank && a != 0 )
+            {
+                rows[i] ^= gfScale( rows[rank], a );
+            }
+        }
+        pivots.push_back( j );
+        rank++;
+    }
+
+    // Every free column gives a basis vector, with the pivot symbols solved
+    vector<unsigned long int> basis;
+    for (int f = 0, p = 0; f < k; ++f)
+    {
+        if ( p < rank && pivots[p] == f )
+        {
+            p++;
+            continue;
+        }
+        unsigned long int b = 1ul << (2 * f);
+        for (int i = 0; i < rank; ++i)
+        {
+            b |= ((rows[i] >> (2 * f)) & 3) << (2 * pivots[i]);
+        }
+        basis.push_back( b );
+    }
+    return basis;
+}
+
+/*
+ * Implementation of the BFS method seeded with a linear code over GF(4). All 
+ * codewords of the code from buildParityCheck are added to the MIS first and
+ * their balls are marked; the alphabetical BFS scan then completes the set to
+ * a maximal one.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum Hamming distance allowed
+ * opts: The options of the run
+ */
+void doCodeSeededBFS( const int k, const int d, const RunOptions &opts )
+{
+    // Initialize dist array for BFS
+    unsigned long int num_kmers = 1ul << (2 * k);
+    DistArray dist_kmer(num_kmers, d);
+
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    for ( const unsigned long int &m : MIS )
+    {
+        markBall( m, k, d, dist_kmer );
+    }
+    TimeBudget budget(opts.timeLimit);
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    unsigned long int code_size = 0;
+    unsigned long int dimension = 0;
+    if ( MIS.empty() )
+    {
+        vector<unsigned long int> basis = 
+            buildGenerator( buildParityCheck(k, d), k );
+
+        // Enumerate the codewords by counting in base 4 over the basis
+        vector<unsigned int> digits(basis.size(), 0);
+        unsigned long int codeword = 0;
+        while ( true )
+        {
+            printMember( codeword, k );
+            MIS.push_back( codeword );
+            markBall( codeword, k, d, dist_kmer );
+
+            unsigned long int i = 0;
+            while ( i < basis.size() && digits[i] == 3 )
+            {
+                codeword ^= gfScale( basis[i], 3 );
+                digits[i++] = 0;
+            }
+            if ( i == basis.size() )
             {
                 break;
             }
-            unordered_set<unsigned long int> neighbors;
-            getNeighbor( Q[0], k, neighbors );
+            codeword ^= gfScale( basis[i], digits[i] ) ^ 
+                        gfScale( basis[i], digits[i] + 1 );
+            digits[i]++;
+        }
+        code_size = MIS.size();
+        dimension = basis.size();
+    }
 
-            for ( auto &j : neighbors )
+    // Complete the set with the alphabetical scan
+    for ( unsigned long int i = opts.resumeCursor; i < num_kmers; ++i )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 4, 2, k, d, i, MIS );
+            break;
+        }
+        if ( dist_kmer[i] != (d + 1)/2 - 1 )
+        {
+            continue;
+        }
+        printMember( i, k );
+        MIS.push_back( i );
+
+        markBall( i, k, d, dist_kmer );
+    }
+
+    if ( code_size > 0 )
+    {
+        cerr << "\nThe first " << code_size << " nodes form a linear [" << k 
+             << ", " << dimension << "] code over GF(4).";
+    }
+    saveResult( opts, 4, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
+         << ".\n\n";
+    reportPerformance();
+}
+
+/*
+ * Reduces a vector by a basis over GF(2) kept in echelon form, where lead[b]
+ * is the basis vector whose highest set bit is b, or 0. Returns 0 if and only
+ * if the vector lies in the span of the basis.
+ *
+ * v   : The vector
+ * lead: The basis indexed by leading bit
+ */
+unsigned long int reduceByBasis( unsigned long int v, 
+                                 const unsigned long int lead[64] )
+{
+    for (int b = 63; b >= 0 && v != 0; --b)
+    {
+        if ( ((v >> b) & 1) && lead[b] != 0 )
+        {
+            v ^= lead[b];
+        }
+    }
+    return v;
+}
+
+/*
+ * Adds a vector to a basis over GF(2) kept in echelon form. Returns false if
+ * the vector already lies in the span of the basis.
+ *
+ * v   : The vector
+ * lead: The basis indexed by leading bit
+ */
+bool addToBasis( unsigned long int v, unsigned long int lead[64] )
+{
+    v = reduceByBasis( v, lead );
+    if ( v == 0 )
+    {
+        return false;
+    }
+    int b = 63;
+    while ( ((v >> b) & 1) == 0 )
+    {
+        b--;
+    }
+    lead[b] = v;
+    return true;
+}
+
+/*
+ * Implementation of the Simple Pairwise Comparison method with alphabetical
+ * order that exploits the linearity of lexicodes. The alphabetical greedy 
+ * produces a lexicode, which over an alphabet of size 4 is closed under 
+ * nim-addition, i.e. XOR of the k-mer encodings. The set after 2^j members is
+ * then spanned by the members at positions 1, 2, 4, ..., 2^(j-1), and the 
+ * next member that is not covered doubles it.
+ *
+ * The scan runs the plain greedy until the MIS has 256 members, checking 
+ * that every member lies in the span of the members at power-of-two 
+ * positions. Once the structure is confirmed, it only searches for the next
+ * basis vector after the largest member, testing coverage by the ball of 
+ * error patterns around the candidate and a membership test in the span, and
+ * generates the other members by XOR. If a member falls outside the span, the 
+ * plain greedy continues to the end. For k <= 8 the result is verified 
+ * against the plain greedy.
+ *
+ * k   : The length of the k-mer
+ * d   : The maximum Hamming distance allowed
+ * opts: The options of the run
+ */
+void doLexicode( const int k, const int d, const RunOptions &opts )
+{
+    unsigned long int kmerSpaceSize = 1ul << (2 * k);
+    const unsigned long int validate_size = 256;
+    vector<unsigned long int> MIS = opts.resumeMIS;
+    unsigned long int lead[64];
+    memset( lead, 0, sizeof(lead) );
+    TimeBudget budget(opts.timeLimit);
+
+    // Rebuild the basis from the members at power-of-two positions
+    bool linear = MIS.empty() || MIS[0] == 0;
+    for ( unsigned long int t = 1; t < MIS.size() && linear; ++t )
+    {
+        if ( (t & (t - 1)) == 0 )
+        {
+            linear = addToBasis( MIS[t], lead );
+        }
+        else
+        {
+            linear = reduceByBasis( MIS[t], lead ) == 0;
+        }
+    }
+
+    // All error patterns of weight at most d
+    vector<unsigned long int> errors(1, 0);
+    for (int w = 0; w < d; ++w)
+    {
+        unsigned long int n = errors.size();
+        for ( unsigned long int e = 0; e < n; ++e )
+        {
+            for (int p = 0; p < k; ++p)
             {
-                if ( hist.find(j) != hist.end() )
+                // Extend patterns in increasing order of positions
+                if ( errors[e] >> (2 * p) != 0 )
                 {
                     continue;
                 }
-                unsigned int targetDist;
-                targetDist = dist_kmer[j];
-                if ( targetDist == (d + 1)/2 - 1 ||
-                     (targetDist != (d + 1)/2 &&
-                      targetDist > q0->second + 1) )
+                for (unsigned long int a = 1; a < 4; ++a)
+                {
+                    errors.push_back( errors[e] | (a << (2 * p)) );
+                }
+            }
+        }
+    }
+    sort( errors.begin(), errors.end() );
+    errors.erase( unique(errors.begin(), errors.end()), errors.end() );
+
+    cerr << "\nList of independent nodes: " << endl;
+    printResumed( opts, k );
+    bool isCovered = false;
+    unsigned long int i = opts.resumeCursor;
+    unsigned long int generated = 0;
+    bool stopped = false;
+    while ( i < kmerSpaceSize && !stopped )
+    {
+        if ( budget.expired() )
+        {
+            saveCheckpoint( opts, 5, 2, k, d, i, MIS );
+            break;
+        }
+
+        if ( !linear || MIS.size() < validate_size )
+        {
+            // Plain greedy step, validating the structure
+            for ( const unsigned long int &j : MIS )
+            {
+                if ( hammingDist(i, j, k, d) <= d )
+                {
+                    isCovered = true;
+                    break;
+                }
+            }
+            if ( isCovered )
+            {
+                isCovered = false;
+                i++;
+                continue;
+            }
+            unsigned long int t = MIS.size();
+            if ( linear && t == 0 )
+            {
+                linear = (i == 0);
+            }
+            else if ( linear && (t & (t - 1)) == 0 )
+            {
+                linear = addToBasis( i, lead );
+            }
+            else if ( linear )
+            {
+                linear = reduceByBasis( i, lead ) == 0;
+            }
+            if ( !linear )
+            {
+                cerr << "(not closed under XOR, continuing the greedy) ";
+            }
+            printMember( i, k );
+            MIS.push_back( i );
+            i++;
+            continue;
+        }
+
+        // Find the next basis vector, using whichever coverage test is cheaper
+        bool found = false;
+        for ( ; i < kmerSpaceSize; ++i )
+        {
+            if ( budget.expired() )
+            {
+                stopped = true;
+                break;
+            }
+            isCovered = false;
+            if ( MIS.size() <= errors.size() )
+            {
+                for ( const unsigned long int &j : MIS )
+                {
+                    if ( hammingDist(i, j, k, d) <= d )
+                    {
+                        isCovered = true;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                for ( const unsigned long int &e : errors )
+                {
+                    if ( reduceByBasis(i ^ e, lead) == 0 )
+                    {
+                        isCovered = true;
+                        break;
+                    }
+                }
+            }
+            if ( !isCovered )
+            {
+                found = true;
+                break;
+            }
+        }
+        isCovered = false;
+        if ( !found && stopped )
+        {
+            saveCheckpoint( opts, 5, 2, k, d, i, MIS );
+        }
+        if ( !found )
+        {
+            continue;
+        }
+
+        // Doublings are few and long, so the clock is read before each
+        if ( budget.expiredNow() )
+        {
+            saveCheckpoint( opts, 5, 2, k, d, i, MIS );
+            break;
+        }
+
+        // Double the code with the new basis vector
+        addToBasis( i, lead );
+        unsigned long int size = MIS.size();
+        unsigned long int largest = 0;
+        for ( unsigned long int t = 0; t < size; ++t )
+        {
+            unsigned long int m = MIS[t] ^ i;
+            printMember( m, k );
+            MIS.push_back( m );
+            if ( m > largest )
+            {
+                largest = m;
+            }
+        }
+        generated += size;
+        i = largest + 1;
+    }
+
+    if ( generated > 0 )
+    {
+        cerr << "\n" << generated << " nodes were generated by linear "
+             << "combination of " << MIS.size() - generated << " nodes found "
+             << "by scanning.";
+    }
+
+    // Verify against the plain greedy on small k
+    if ( k <= 8 && i >= kmerSpaceSize )
+    {
+        vector<unsigned long int> greedy;
+        for ( unsigned long int x = 0; x < kmerSpaceSize; ++x )
+        {
+            for ( const unsigned long int &j : greedy )
+            {
+                if ( hammingDist(x, j, k, d) <= d )
                 {
-                    dist_kmer.setDist( j, q0->second + 1 );
-                    Q.push_back(j);
-                    hist.emplace( j, q0->second + 1 );
+                    isCovered = true;
+                    break;
                 }
             }
-            Q.pop_front();
+            if ( isCovered )
+            {
+                isCovered = false;
+                continue;
+            }
+            greedy.push_back( x );
         }
+        vector<unsigned long int> sorted_MIS = MIS;
+        sort( sorted_MIS.begin(), sorted_MIS.end() );
+        cerr << "\nVerification against the plain greedy: " 
+             << (sorted_MIS == greedy ? "identical" : "DIFFERENT") << '.';
     }
 
-    cerr << "\nThe graph has an independent set of size " << num_indep_nodes 
+    saveResult( opts, 5, 2, k, d, MIS );
+    cerr << "\nThe graph has an independent set of size " << MIS.size() 
          << ".\n\n";
     reportPerformance();
 }
 
-int main()
+/*
+ * Finishes writing the independent nodes to the output file, if one was given
+ *
+ * filename: The output file
+ */
+void closeMemberOutput( const string &filename )
+{
+    if ( memberOutput == nullptr )
+    {
+        return;
+    }
+    if ( memberOutput->finish() )
+    {
+        cerr << "The independent nodes were written to " << filename 
+             << " using " << memberOutput->backend() << ".\n";
+    }
+    else
+    {
+        cerr << "Failed to write the independent nodes to " << filename 
+             << ".\n";
+    }
+    delete memberOutput;
+    memberOutput = nullptr;
+}
+
+int main( int argc, char *argv[] )
 {
     cerr << "This program is used to find a MIS in a k-mer space. Valid inputs"
          << " for the integer parameters k and d should satisfy 2<=k<=30 and"
          << " 1<=d<k.\n";
 
+    // Parse the optional arguments
+    RunOptions opts;
+    string resumeFile;
+    string cacheDir;
+    bool seedGiven = false;
+    string outputFile;
+    for (int i = 1; i < argc; ++i)
+    {
+        if ( strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc )
+        {
+            opts.timeLimit = atof( argv[++i] );
+        }
+        else if ( strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc )
+        {
+            opts.checkpointFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--resume") == 0 && i + 1 < argc )
+        {
+            resumeFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--cache") == 0 && i + 1 < argc )
+        {
+            cacheDir = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--seed") == 0 && i + 1 < argc )
+        {
+            opts.seed = strtoul( argv[++i], nullptr, 10 );
+            seedGiven = true;
+        }
+        else if ( strcmp(argv[i], "--output") == 0 && i + 1 < argc )
+        {
+            outputFile = argv[++i];
+        }
+        else if ( strcmp(argv[i], "--witness") == 0 && i + 1 < argc )
+        {
+            opts.witnessFile = argv[++i];
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--time-limit SECONDS] "
+                 << "[--checkpoint FILE] [--resume FILE] [--cache DIR] "
+                 << "[--seed N] [--output FILE] [--witness FILE]\n";
+            return 1;
+        }
+    }
+
     int k;
     int d;
     int method;
     int random;
-    cerr << "Please enter k: ";
-    cin >> k;
-    cerr << k << endl;
-    cerr << "Plesae enter d: ";
-    cin >> d;
-    cerr << d << endl;
-    cerr << "Please choose an approach. Notice that the BFS approach does not " 
-         << "support d>5. Enter 1 for Simple Greedy, 2 for Improved Greedy, "
-         << "or 3 for BFS: ";
-    cin >> method;
-    cerr << method << endl;
-    cerr << "The iteration order of k-mers affects the resulting MIS size and "
-         << "the performance of the program.\n"
-         << "Please choose the iteration order of k-mers. Enter 1 for random "
-         << "order or 2 for alphabetical order: ";
-    cin >> random;
-    cerr << random << endl;
+
+    // A resumed run takes its parameters from the checkpoint
+    if ( !resumeFile.empty() )
+    {
+        MISFileHeader header;
+        if ( !readMISFile(resumeFile, header, opts.resumeMIS) || 
+             header.metric != METRIC )
+        {
+            cerr << "Cannot resume from " << resumeFile << ".\n";
+            return 1;
+        }
+        k = header.k;
+        d = header.d;
+        method = header.method;
+        random = header.order;
+        opts.resumeCursor = header.cursor;
+        opts.seed = header.seed;
+        cerr << "Resuming k=" << k << ", d=" << d << ", approach " << method
+             << ", order " << random << " at iteration " << header.cursor 
+             << " with " << opts.resumeMIS.size() << " independent nodes.\n";
+    }
+    else
+    {
+        cerr << "Please enter k: ";
+        cin >> k;
+        cerr << k << endl;
+        cerr << "Plesae enter d: ";
+        cin >> d;
+        cerr << d << endl;
+        cerr << "Please choose an approach. Notice that the BFS approaches do "
+             << "not support d>5. Enter 1 for Simple Greedy, 2 for Improved "
+             << "Greedy, 3 for BFS, 4 for BFS seeded with a linear code, or 5 "
+             << "for Lexicode Generation (4 and 5 in alphabetical order "
+             << "only): ";
+        cin >> method;
+        cerr << method << endl;
+        cerr << "The iteration order of k-mers affects the resulting MIS size "
+             << "and the performance of the program.\n"
+             << "Please choose the iteration order of k-mers. Enter 1 for "
+             << "random order or 2 for alphabetical order: ";
+        cin >> random;
+        cerr << random << endl;
+    }
+
+    if ( !outputFile.empty() )
+    {
+        memberOutput = new AsyncWriter(outputFile);
+        if ( !memberOutput->good() )
+        {
+            cerr << "Cannot open " << outputFile << ".\n";
+            return 1;
+        }
+    }
+
+    // A clock seed never recurs, so its entry could never be hit again
+    if ( !cacheDir.empty() && random == 1 && !seedGiven && 
+         resumeFile.empty() )
+    {
+        cerr << "Runs in random order without --seed are not cached.\n";
+        cacheDir.clear();
+    }
+
+    // A cached result is reused, a cached snapshot continued
+    if ( !cacheDir.empty() && resumeFile.empty() && 
+         lookupCache(cacheDir, k, d, method, random, opts) )
+    {
+        closeMemberOutput( outputFile );
+        return 0;
+    }
 
     if ( random == 2 )
     {
         if ( method == 1 )
         {
-            doPairwiseCmp( k, d );
+            doPairwiseCmp( k, d, opts );
         }
         else if ( method == 2 )
         {
-            doHeuristic( k, d );
+            doHeuristic( k, d, opts );
         }
         else if ( method == 3 )
         {
-            doBFS( k, d );
+            doBFS( k, d, opts );
+        }
+        else if ( method == 4 )
+        {
+            doCodeSeededBFS( k, d, opts );
+        }
+        else if ( method == 5 )
+        {
+            doLexicode( k, d, opts );
         }
     }
     else if ( random == 1 )
     {
         if ( method == 1 )
         {
-            doRandPairwiseCmp( k, d );
+            doRandPairwiseCmp( k, d, opts );
         }
         else if ( method == 2 )
         {
-            doRandHeuristic( k, d );
+            doRandHeuristic( k, d, opts );
         }
         else if ( method == 3 )
         {
-            doRandBFS( k, d );
+            doRandBFS( k, d, opts );
         }
     }
+    closeMemberOutput( outputFile );
     return 0;
 }
@@ -0,0 +1,99 @@
+/*
+ * The bit-parallel edit distance kernel shared by findMIS and misSetOps, so
+ * that a fix to it is made in one place.
+ */
+
+#ifndef LEVENSHTEIN_H
+#define LEVENSHTEIN_H
+
+/*
+ * A bit-parallel Levenshtein automaton for threshold d compiled from one 
+ * k-mer, i.e. the match masks of Myers' algorithm. Compiling it once per
+ * candidate takes the preprocessing out of the loop over the MIS, so each 
+ * member costs one table lookup and a few word operations per base.
+ */
+class LevenshteinAutomaton
+{
+private:
+    unsigned long int peq[4]; // Match masks of the compiled k-mer per base
+    unsigned long int mask;   // The lowest k bits
+    int k;                    // The length of the k-mers
+    int d;                    // The maximum edit distance allowed
+
+public:
+    /*
+     * Constructor
+     *
+     * enc    : The binary encoding of the k-mer to compile
+     * len    : The length of the k-mer, at most 63
+     * maxDist: The maximum edit distance allowed
+     */
+    LevenshteinAutomaton( unsigned long int enc, int len, int maxDist )
+    {
+        k = len;
+        d = maxDist;
+        mask = (1ul << k) - 1;
+        peq[0] = peq[1] = peq[2] = peq[3] = 0;
+        for (int i = 0; i < k; ++i)
+        {
+            peq[(enc >> (2 * i)) & 3] |= 1ul << i;
+        }
+    }
+
+    /*
+     * Runs a k-mer through the automaton and returns its edit distance to the
+     * compiled k-mer. If the distance exceeds d, the returned value is only
+     * guaranteed to be larger than d.
+     *
+     * s: The binary encoding of the k-mer
+     */
+    int dist( unsigned long int s ) const
+    {
+        return dist( s, d );
+    }
+
+    /*
+     * Runs a k-mer through the automaton with a bound other than the one it
+     * was compiled with. If the distance exceeds maxDist, the returned value 
+     * is only guaranteed to be larger than maxDist.
+     *
+     * s      : The binary encoding of the k-mer
+     * maxDist: The maximum edit distance of interest
+     */
+    int dist( unsigned long int s, int maxDist ) const
+    {
+        unsigned long int high = 1ul << (k - 1);
+        unsigned long int pv = mask;
+        unsigned long int mv = 0;
+        int score = k;
+        for (int j = 0; j < k; ++j)
+        {
+            unsigned long int eq = peq[(s >> (2 * j)) & 3];
+            unsigned long int xv = eq | mv;
+            unsigned long int xh = (((eq & pv) + pv) ^ pv) | eq;
+            unsigned long int ph = mv | ~(xh | pv);
+            unsigned long int mh = pv & xh;
+            if ( ph & high )
+            {
+                score++;
+            }
+            else if ( mh & high )
+            {
+                score--;
+            }
+
+            // The score can decrease by at most 1 per remaining column
+            if ( score - (k - 1 - j) > maxDist )
+            {
+                return score - (k - 1 - j);
+            }
+            ph = (ph << 1) | 1;
+            mh = mh << 1;
+            pv = (mh | ~(xv | ph)) & mask;
+            mv = ph & xv;
+        }
+        return score;
+    }
+};
+
+#endif
@@ -0,0 +1,476 @@
+/*
+ * This program compares two independent sets of k-mers saved in the binary
+ * MIS files written by findMIS and findMISHamming (with --checkpoint or
+ * --cache). It reports the sizes of their intersection, differences and union,
+ * their Jaccard similarity, and how many members of each set are within
+ * distance d of the other set. With --verify it checks a witness file 
+ * written with --witness instead, which proves that a set is maximal.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+#include <fcntl.h>
+#include <immintrin.h>
+#include "levenshtein.h"
+#include "misfile.h"
+
+using namespace std;
+
+/*
+ * Calculates the edit distance between 2 k-mers with Myers' bit-parallel
+ * algorithm (global variant by Hyyro). If the distance exceeds d, the
+ * returned value is only guaranteed to be larger than d.
+ *
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ * k : The length of the two k-mers
+ * d : The maximum edit distance allowed
+ */
+int editDist( const unsigned long int s1, const unsigned long int s2,
+              const int k, const int d )
+{
+    return LevenshteinAutomaton( s1, k, d ).dist( s2 );
+}
+
+/*
+ * Calculates the Hamming distance between 2 k-mers
+ *
+ * s1: The encoding of the first k-mer
+ * s2: The encoding of the second k-mer
+ */
+int hammingDist( const unsigned long int s1, const unsigned long int s2 )
+{
+    unsigned long int temp = s1 ^ s2;
+    temp = (temp | (temp >> 1)) & 0x5555555555555555ul;
+    return __builtin_popcountl( temp );
+}
+
+/*
+ * Counts the common elements of two sorted arrays of distinct values with a
+ * branchless merge
+ *
+ * a: The first array
+ * b: The second array
+ */
+unsigned long int intersectScalar( const vector<unsigned long int> &a,
+                                   const vector<unsigned long int> &b )
+{
+    unsigned long int i = 0, j = 0, count = 0;
+    while ( i < a.size() && j < b.size() )
+    {
+        unsigned long int x = a[i];
+        unsigned long int y = b[j];
+        count += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return count;
+}
+
+/*
+ * Counts the common elements of two sorted arrays of distinct values,
+ * comparing blocks of 4 against blocks of 4 with AVX2. Each block of a is
+ * compared against the 4 rotations of the block of b, and the block with the
+ * smaller last element is advanced.
+ *
+ * a: The first array
+ * b: The second array
+ */
+__attribute__((target("avx2")))
+unsigned long int intersectAVX2( const vector<unsigned long int> &a,
+                                 const vector<unsigned long int> &b )
+{
+    unsigned long int i = 0, j = 0, count = 0;
+    while ( i + 4 <= a.size() && j + 4 <= b.size() )
+    {
+        __m256i va = _mm256_loadu_si256( (const __m256i *) &a[i] );
+        __m256i vb = _mm256_loadu_si256( (const __m256i *) &b[j] );
+        __m256i eq = _mm256_cmpeq_epi64( va, vb );
+        vb = _mm256_permute4x64_epi64( vb, 0x39 );
+        eq = _mm256_or_si256( eq, _mm256_cmpeq_epi64(va, vb) );
+        vb = _mm256_permute4x64_epi64( vb, 0x39 );
+        eq = _mm256_or_si256( eq, _mm256_cmpeq_epi64(va, vb) );
+        vb = _mm256_permute4x64_epi64( vb, 0x39 );
+        eq = _mm256_or_si256( eq, _mm256_cmpeq_epi64(va, vb) );
+        count += __builtin_popcount(
+                     _mm256_movemask_pd(_mm256_castsi256_pd(eq)) );
+
+        unsigned long int last_a = a[i + 3];
+        unsigned long int last_b = b[j + 3];
+        i += last_a <= last_b ? 4 : 0;
+        j += last_b <= last_a ? 4 : 0;
+    }
+
+    // Finish the tails with the scalar merge
+    while ( i < a.size() && j < b.size() )
+    {
+        unsigned long int x = a[i];
+        unsigned long int y = b[j];
+        count += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return count;
+}
+
+/*
+ * An index of a set of k-mers for finding a member within distance d of a
+ * query. Each member is split into d+1 pieces; a k-mer within distance d of
+ * a member matches one of its pieces exactly, shifted by at most d positions
+ * under the edit distance and not shifted under the Hamming distance.
+ */
+class PigeonholeIndex
+{
+private:
+    const vector<unsigned long int> &members; // The indexed set
+    int k;                                    // The length of the k-mers
+    int d;                                    // The maximum distance
+    bool edit;                                // False for Hamming
+    vector<int> start;                        // The first base of each piece
+    vector<int> len;                          // The length of each piece
+    vector<unordered_map<unsigned long int, vector<unsigned int>>> pieces;
+
+    /*
+     * Extracts a substring of a k-mer
+     *
+     * enc  : The encoding of the k-mer
+     * first: The first base, counted from the left
+     * n    : The number of bases
+     */
+    unsigned long int substring( unsigned long int enc, int first,
+                                 int n ) const
+    {
+        return (enc >> (2 * (k - first - n))) & ((1ul << (2 * n)) - 1);
+    }
+
+public:
+    /*
+     * Constructor
+     *
+     * M     : The set to index
+     * len_k : The length of the k-mers
+     * maxD  : The maximum distance, less than len_k
+     * metric: 'E' for the edit distance, 'H' for Hamming
+     */
+    PigeonholeIndex( const vector<unsigned long int> &M, int len_k, int maxD,
+                     char metric ) : members(M), k(len_k), d(maxD),
+                                     edit(metric == 'E'), pieces(maxD + 1)
+    {
+        for (int j = 0; j <= d; ++j)
+        {
+            start.push_back( j * k / (d + 1) );
+            len.push_back( (j + 1) * k / (d + 1) - j * k / (d + 1) );
+        }
+        for (unsigned int m = 0; m < members.size(); ++m)
+        {
+            for (int j = 0; j <= d; ++j)
+            {
+                pieces[j][substring(members[m], start[j], len[j])]
+                    .push_back( m );
+            }
+        }
+    }
+
+    /*
+     * Returns true if a member is within distance d of a k-mer
+     *
+     * query: The encoding of the k-mer
+     */
+    bool covers( unsigned long int query ) const
+    {
+        int shift = edit ? d : 0;
+        for (int j = 0; j <= d; ++j)
+        {
+            for (int s = -shift; s <= shift; ++s)
+            {
+                int first = start[j] + s;
+                if ( first < 0 || first + len[j] > k )
+                {
+                    continue;
+                }
+                unordered_map<unsigned long int, vector<unsigned int>>::
+                    const_iterator it =
+                    pieces[j].find( substring(query, first, len[j]) );
+                if ( it == pieces[j].end() )
+                {
+                    continue;
+                }
+                for ( const unsigned int &m : it->second )
+                {
+                    int dist = edit ? editDist(query, members[m], k, d) :
+                                      hammingDist(query, members[m]);
+                    if ( dist <= d )
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+/*
+ * Counts the members of a set within distance d of another set
+ *
+ * from : The set whose members are counted
+ * index: The index of the other set
+ */
+unsigned long int countCovered( const vector<unsigned long int> &from,
+                                const PigeonholeIndex &index )
+{
+    unsigned long int count = 0;
+    for ( const unsigned long int &x : from )
+    {
+        count += index.covers( x );
+    }
+    return count;
+}
+
+/*
+ * Checks the witnesses of a range of k-mers, reading the packed indices from
+ * the file in blocks. Every k-mer must have a valid index of a member within
+ * distance d. Returns the number of k-mers that fail, and the first of them.
+ *
+ * fd     : The witness file
+ * header : The header of the witness file
+ * members: The members listed in the witness file
+ * first  : The first k-mer to check, a multiple of 64
+ * last   : One past the last k-mer to check, a multiple of 64 or 4^k
+ * failed : The first k-mer that failed, untouched if none did
+ */
+unsigned long int checkWitnesses( int fd, const WitnessFileHeader &header,
+                                  const vector<unsigned long int> &members,
+                                  unsigned long int first,
+                                  unsigned long int last,
+                                  unsigned long int &failed )
+{
+    // 64 k-mers take exactly "bits" words
+    const unsigned long int block = 1ul << 16;
+    int bits = header.bits;
+    unsigned long int mask = (1ul << bits) - 1;
+    off_t base = sizeof(header) + header.size * 8;
+    vector<unsigned long int> words(block / 64 * bits + 1);
+    unsigned long int count = 0;
+    for (unsigned long int lo = first; lo < last; lo += block)
+    {
+        unsigned long int hi = min( lo + block, last );
+        size_t len = ((hi - lo) * bits + 63) / 64 * 8;
+        if ( pread(fd, words.data(), len, base + lo / 64 * bits * 8) != 
+             (ssize_t) len )
+        {
+            failed = count ? failed : lo;
+            return count + (last - lo);
+        }
+        for (unsigned long int x = lo; x < hi; ++x)
+        {
+            unsigned long int pos = (x - lo) * bits;
+            unsigned long int w = words[pos / 64] >> (pos % 64);
+            if ( pos % 64 + bits > 64 )
+            {
+                w |= words[pos / 64 + 1] << (64 - pos % 64);
+            }
+            w &= mask;
+            bool ok = w < members.size() && 
+                      (header.metric == 'E' ?
+                       editDist(x, members[w], header.k, header.d) :
+                       hammingDist(x, members[w])) <= header.d;
+            if ( !ok && count++ == 0 )
+            {
+                failed = x;
+            }
+        }
+    }
+    return count;
+}
+
+/*
+ * Verifies that the set in a witness file is maximal, each thread streaming
+ * through its own range of the k-mers with one distance calculation per 
+ * k-mer. Returns 0 if the set is maximal.
+ *
+ * filename   : The witness file
+ * num_threads: The number of threads
+ */
+int verifyWitnesses( const char *filename, unsigned int num_threads )
+{
+    WitnessFileHeader header;
+    int fd = open( filename, O_RDONLY );
+    if ( fd < 0 || pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+         memcmp(header.magic, "KWIT", 4) != 0 || header.version != 1 ||
+         header.k < 1 || header.k > 31 || header.bits < 1 || 
+         header.bits > 63 )
+    {
+        cerr << "Cannot read " << filename << ".\n";
+        return 1;
+    }
+    vector<unsigned long int> members(header.size);
+    if ( pread(fd, members.data(), header.size * 8, sizeof(header)) != 
+         (ssize_t) (header.size * 8) )
+    {
+        cerr << "Cannot read " << filename << ".\n";
+        return 1;
+    }
+    cerr << filename << ": " << header.size << " members, k=" << header.k
+         << ", d=" << header.d << ", " << (int) header.bits 
+         << " bits per witness.\n";
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned long int num_kmers = 1ul << (2 * header.k);
+    unsigned long int chunks = (num_kmers + 63) / 64;
+    num_threads = max( 1u, min<unsigned int>(num_threads, chunks) );
+    vector<unsigned long int> counts(num_threads, 0);
+    vector<unsigned long int> firsts(num_threads, 0);
+    vector<thread> workers;
+    for (unsigned int t = 0; t < num_threads; ++t)
+    {
+        unsigned long int first = chunks * t / num_threads * 64;
+        unsigned long int last = min( chunks * (t + 1) / num_threads * 64, 
+                                      num_kmers );
+        workers.push_back( thread([&, t, first, last]()
+        {
+            counts[t] = checkWitnesses( fd, header, members, first, last, 
+                                        firsts[t] );
+        }) );
+    }
+    unsigned long int failures = 0;
+    unsigned long int first_failure = 0;
+    for (unsigned int t = 0; t < num_threads; ++t)
+    {
+        workers[t].join();
+        if ( counts[t] > 0 && failures == 0 )
+        {
+            first_failure = firsts[t];
+        }
+        failures += counts[t];
+    }
+    close( fd );
+    double check_time = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+
+    cerr << "Checked " << num_kmers << " k-mers with " << num_threads 
+         << " threads in " << check_time << " sec.\n";
+    if ( failures > 0 )
+    {
+        cerr << failures << " k-mers have no valid witness, the first is "
+             << first_failure << ". The set is not proven maximal.\n";
+        return 1;
+    }
+    cerr << "Every k-mer is within distance " << header.d << " of its "
+         << "witness, so the set is maximal.\n";
+    return 0;
+}
+
+/*
+ * Prints the parameters of an MIS file
+ *
+ * filename: The name of the file
+ * header  : The header of the file
+ */
+void printHeader( const char *filename, const MISFileHeader &header )
+{
+    cerr << filename << ": " << header.size << " members, k=" << header.k
+         << ", d=" << header.d << ", approach " << (int) header.method
+         << ", order " << (int) header.order
+         << (header.complete ? "" : ", incomplete") << ".\n";
+}
+
+int main( int argc, char *argv[] )
+{
+    if ( argc >= 3 && strcmp(argv[1], "--verify") == 0 )
+    {
+        unsigned int num_threads = max( 1u, thread::hardware_concurrency() );
+        if ( argc == 5 && strcmp(argv[3], "--threads") == 0 )
+        {
+            num_threads = atoi( argv[4] );
+        }
+        else if ( argc != 3 )
+        {
+            num_threads = 0;
+        }
+        if ( num_threads > 0 )
+        {
+            return verifyWitnesses( argv[2], num_threads );
+        }
+    }
+    if ( argc != 3 && !(argc == 5 && strcmp(argv[3], "--dist") == 0) )
+    {
+        cerr << "Usage: " << argv[0] << " A.kmis B.kmis [--dist D]\n"
+             << "       " << argv[0] << " --verify W.kwit [--threads N]\n"
+             << "Compares two MIS files written by findMIS or "
+             << "findMISHamming, or checks\na witness file written with "
+             << "--witness.\n";
+        return 1;
+    }
+
+    MISFileHeader header_a, header_b;
+    vector<unsigned long int> A, B;
+    if ( !readMISFile(argv[1], header_a, A) )
+    {
+        cerr << "Cannot read " << argv[1] << ".\n";
+        return 1;
+    }
+    if ( !readMISFile(argv[2], header_b, B) )
+    {
+        cerr << "Cannot read " << argv[2] << ".\n";
+        return 1;
+    }
+    if ( header_a.k != header_b.k || header_a.metric != header_b.metric )
+    {
+        cerr << "The files hold k-mers of different lengths or metrics.\n";
+        return 1;
+    }
+    int k = header_a.k;
+    int d = argc == 5 ? atoi( argv[4] ) : header_a.d;
+    if ( d < 1 || d >= k )
+    {
+        cerr << "The distance should satisfy 1<=d<k.\n";
+        return 1;
+    }
+    printHeader( argv[1], header_a );
+    printHeader( argv[2], header_b );
+
+    sort( A.begin(), A.end() );
+    sort( B.begin(), B.end() );
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned long int common = __builtin_cpu_supports("avx2") ?
+                               intersectAVX2( A, B ) :
+                               intersectScalar( A, B );
+    double merge_time = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+    unsigned long int united = A.size() + B.size() - common;
+
+    cerr << "\nIntersection: " << common
+         << "\nOnly in A:    " << A.size() - common
+         << "\nOnly in B:    " << B.size() - common
+         << "\nUnion:        " << united
+         << "\nJaccard:      " << (united ? (double) common / united : 1.0)
+         << "\n(merged in " << merge_time * 1000 << " ms with "
+         << (__builtin_cpu_supports("avx2") ? "AVX2" : "scalar code")
+         << ")\n";
+
+    start = chrono::steady_clock::now();
+    PigeonholeIndex index_a(A, k, d, header_a.metric);
+    PigeonholeIndex index_b(B, k, d, header_a.metric);
+    unsigned long int a_near_b = countCovered( A, index_b );
+    unsigned long int b_near_a = countCovered( B, index_a );
+    double cross_time = chrono::duration<double>(
+        chrono::steady_clock::now() - start).count();
+
+    cerr << "\nMembers of A within distance " << d << " of B: " << a_near_b
+         << " (" << (A.empty() ? 0 : a_near_b * 100.0 / A.size()) << "%)"
+         << "\nMembers of B within distance " << d << " of A: " << b_near_a
+         << " (" << (B.empty() ? 0 : b_near_a * 100.0 / B.size()) << "%)"
+         << "\n(computed in " << cross_time << " sec)\n";
+    return 0;
+}
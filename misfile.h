@@ -0,0 +1,92 @@
+/*
+ * The binary file formats shared by findMIS, findMISHamming and misSetOps, so
+ * that the three programs read and write the same layout.
+ */
+
+#ifndef MISFILE_H
+#define MISFILE_H
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Header of the binary files holding an independent set. It is followed by
+ * the encodings of the members as 8-byte integers in the order they were 
+ * added.
+ */
+struct MISFileHeader
+{
+    char magic[4];            // Always "KMIS"
+    unsigned int version;     // Format version, currently 1
+    char metric;              // 'E' for the edit distance, 'H' for Hamming
+    char complete;            // 1 if the set is maximal, 0 if the scan stopped
+    char method;              // The approach chosen in main
+    char order;               // The iteration order chosen in main
+    int k;                    // The length of the k-mers
+    int d;                    // The maximum distance allowed
+    unsigned int seed;        // The seed of a random iteration order
+    unsigned long int cursor; // The next iteration of the main scan
+    unsigned long int size;   // The number of members
+};
+
+/*
+ * Header of the binary witness files, which certify that an independent set
+ * is maximal. The header is followed by the members as 8-byte k-mer encodings
+ * and then, for every k-mer in alphabetical order, the index of a member 
+ * within distance d, packed LSB first into 8-byte words with "bits" bits each.
+ */
+struct WitnessFileHeader
+{
+    char magic[4];          // Always "KWIT"
+    unsigned int version;   // Format version, currently 1
+    char metric;            // 'E' for the edit distance, 'H' for Hamming
+    char bits;              // The bits per member index
+    int k;                  // The length of the k-mers
+    int d;                  // The maximum distance allowed
+    unsigned long int size; // The number of members
+};
+
+/*
+ * Writes an independent set to a binary file. Returns true on success.
+ *
+ * filename: The output file
+ * header  : The header, whose magic, version and size are filled in here
+ * MIS     : The members of the independent set
+ */
+inline bool writeMISFile( const std::string &filename, MISFileHeader header, 
+                          const std::vector<unsigned long int> &MIS )
+{
+    memcpy( header.magic, "KMIS", 4 );
+    header.version = 1;
+    header.size = MIS.size();
+    std::ofstream out_stream(filename.c_str(), 
+                             std::ios_base::out | std::ios_base::binary);
+    out_stream.write( (char *) &header, sizeof(header) );
+    out_stream.write( (char *) MIS.data(), MIS.size() * 8 );
+    return out_stream.good();
+}
+
+/*
+ * Reads an independent set from a binary file. Returns true on success.
+ *
+ * filename: The input file
+ * header  : The header read from the file
+ * MIS     : A vector to hold the members
+ */
+inline bool readMISFile( const std::string &filename, MISFileHeader &header, 
+                         std::vector<unsigned long int> &MIS )
+{
+    std::ifstream in_stream(filename.c_str(), 
+                            std::ios_base::in | std::ios_base::binary);
+    if ( !in_stream.read((char *) &header, sizeof(header)) || 
+         memcmp(header.magic, "KMIS", 4) != 0 || header.version != 1 )
+    {
+        return false;
+    }
+    MIS.resize( header.size );
+    return (bool) in_stream.read( (char *) MIS.data(), header.size * 8 );
+}
+
+#endif